@@ -5,19 +5,43 @@
  * Created on August 4, 2013, 9:10 PM
  */
 
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+#include <climits>
+#include <limits>
+#include <array>
 #include <algorithm>
-#include "Memory.h"
+#include <thread>
 #include "ConvexHull.h"
 
+#ifdef CONVEXHULL_PREC
+#define PREC    (CONVEXHULL_PREC) // precision (make PREC=...)
+#else
 #define PREC    (1.0e-6)        // precision
+#endif
 #define SCALE   (1.0 / PREC)    // scale
 #define NTV     (4)            // number of tetrahedron vertices
 #define NDV     (3)            // number of dihedron vertices
+#define NFAN    (16)           // number of faces judged at once around the vertex
+#define NMINV   (7)            // minimum number of vertices
+#define NMAXV   (numeric_limits<ID>::max() / 3) // maximum number of vertices, ids of edges are less than 3 times it
+#define MAGIC   (6755399441055744.0)            // 2^52 + 2^51
+#define MAGICBITS (0x4338000000000000LL)        // bits of MAGIC
+#define NCULL   (4096)         // minimum number of vertices to cull on the thread
+#define NCBLK   (256)          // number of vertices judged at once on the culling
+#define NSORT   (65536)        // minimum number of vertices to sort on the thread
+#define NSAMPLE (64)           // number of samples of the sort on each thread
+#define NRECONST (64)          // vertices are constructed again if 1 / NRECONST of them overlap the convex hull on the append
+#define CULLEPS (8.0 * DBL_EPSILON / 2.0)       // relative error bound of the culling
 
 /**
  * Constructor and Destructor
  */
-ConvexHull::ConvexHull() {
+ConvexHull::ConvexHull() : nthr(1), order(MergeOrder::BREADTH_FIRST), culling(Culling::NONE), nin(0), lastf(NOID), hcset(false), silset(false), cancelled(false) {
+    ictx.pool.reserved = false;
+    ictx.epoch = 0;
+    ictx.ndv = 0;
 }
 
 ConvexHull::~ConvexHull() {
@@ -29,41 +53,977 @@ ConvexHull::~ConvexHull() {
 void ConvexHull::clear() {
     GeoGraph::clear();
     hva.clear();
+    kiv.clear();
     kch.clear();
+    kchnv.clear();
     khnv.clear();
     khpv.clear();
     kcnxv.clear();
     kccnxv.clear();
+    kep.clear();
+    kfp.clear();
+    nin = 0;
+    ictx.epoch = 0;
+    lastf = NOID;
+    hcset = false;
+    silset = false;
+}
+
+/**
+ * Snaps the vertex on the grid of PREC
+ *  - rounds to the nearest integer by the magic number of 2^52 + 2^51
+ *    without the conversion instruction, so that the loop is vectorized
+ *  - coordinates must be at most GRIDMAX * PREC (about 1e6) in magnitude,
+ *    so that determinants of the predicate fit in INT128,
+ *    and GRIDMAX is 2^31 - 1 (about 2e3) if GRID is 32 bit,
+ *    the vertex out of the range, or not a number, is judged
+ * @param x, y and z of the vertex
+ * @param x, y and z on the grid
+ * @return in the range of the grid or not
+ */
+static inline bool snap(const double* v, GRID* g) {
+    bool in = true;
+    for (int k = 0; k < 3; k++) {
+        double s = v[k] * SCALE;
+        double t = s + MAGIC;
+        INT64 b;
+        memcpy(&b, &t, sizeof(b));
+        g[k] = (GRID)(b - MAGICBITS);
+        in &= (fabs(s) <= GRIDMAX);
+    }
+    return in;
 }
 
 /**
  * Constructs the 3d convex hull
+ *  - vertices may be in any order and duplicated,
+ *    vertices on the grid are sorted on threads and inputIndex() gives
+ *    the index in the vertex array of each vertex
  * @param vertex array
+ * @return constructed, or cancelled, too many vertices for ids
+ *         or vertices out of the range of the grid
+ */
+bool ConvexHull::construct(const vector<Vector3d>& va) {
+    // views the vertex array without copies, vectors are x, y and z
+    return construct(VertexView(va.data(), va.size(), sizeof(Vector3d), VertexView::Type::FLOAT64));
+}
+
+/**
+ * Constructs the 3d convex hull from the vertex view
+ *  - vertices may be in any order and duplicated,
+ *    they are snapped on the grid at once from the view and sorted in x order
+ *  - inputIndex() gives the index in the view of each vertex
+ * @param vertex view
+ * @return constructed, or cancelled, too many vertices for ids
+ *         or vertices out of the range of the grid
  */
-void ConvexHull::construct(const vector<Vector3d>& va) {
+bool ConvexHull::construct(const VertexView& vw) {
     clear();
-    // copies vertex array
-    for_each(va.begin(), va.end(), [&](Vector3d v) {
-        hva.push_back(v * SCALE);
+    Statistics::reset();
+    stats.clear();
+    cancelled = false;
+    if (vw.size() > (size_t)NMAXV) {
+        return false;
+    }
+    // snaps vertices on the grid
+    ID nv = vw.size();
+    hva.resize(3 * nv);
+    bool in = true;
+    for (ID i = 0; i < nv; i++) {
+        double v[3];
+        vw.get(i, v);
+        in &= snap(v, &hva[3*i]);
+    }
+    if (!in) {
+        clear();
+        return false;
+    }
+    nin = nv;
+    cullVertices();
+    sortVertices(0);
+    constConvexHull();
+    // leaves the empty convex hull if cancelled
+    if (cancelled) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Extracts the indexed mesh of the convex hull
+ *  - numbers vertices on the convex hull, and gathers edges and triangles
+ *    by linear passes over lists of vertices, edges and faces
+ * @param indexed mesh
+ */
+void ConvexHull::extract(Mesh& mesh) const {
+    // numbers vertices in order of ids
+    vector<ID> kvn(vertexBound(), NOID);
+    mesh.kvi.clear();
+    for (ID iv = 0; iv < vertexBound(); iv++) {
+        if (isVertex(iv)) {
+            kvn[iv] = mesh.kvi.size();
+            mesh.kvi.push_back(inputIndex(iv));
+        }
+    }
+    // gathers edges
+    mesh.ke.clear();
+    mesh.ke.reserve(2 * ker.size());
+    for (ID e = 0; e < (ID)ker.size(); e++) {
+        if (ker[e].sv != NOID) {
+            mesh.ke.push_back(kvn[ker[e].sv]);
+            mesh.ke.push_back(kvn[ker[e].ev]);
+        }
+    }
+    // gathers triangles
+    mesh.kt.clear();
+    mesh.kt.reserve(3 * faceBound());
+    for (ID f = 0; f < faceBound(); f++) {
+        if (isFace(f)) {
+            ID kv[3];
+            getVerticesOfTriangle(f, kv);
+            mesh.kt.push_back(kvn[kv[0]]);
+            mesh.kt.push_back(kvn[kv[1]]);
+            mesh.kt.push_back(kvn[kv[2]]);
+        }
+    }
+}
+
+/**
+ * Inserts the vertex into the constructed convex hull
+ *  - the vertex is appended to vertices, inputIndex() of it is
+ *    the number of vertices in the input so far
+ *  - patches faces visible from the vertex in place
+ *    without the construction of the whole convex hull
+ *  - the vertex out of the range of the grid is not inserted
+ * @param vertex
+ * @return the vertex is on the convex hull or not
+ */
+bool ConvexHull::insert(const Vector3d& v) {
+    // appends the vertex on the grid
+    ID iv = numVertices();
+    hva.resize(3 * iv + 3);
+    if (!snap(v.get(), &hva[3*iv])) {
+        // skips the vertex out of the range, but counts it in the input
+        hva.resize(3 * iv);
+        for (ID i = kiv.size(); i < iv; i++) {
+            kiv.push_back(i);
+        }
+        nin++;
+        return false;
+    }
+    if (!kiv.empty() || nin != iv) {
+        kiv.push_back(nin);
+    }
+    nin++;
+    kve.push_back(NOID);
+    kchnv.push_back(0);
+    khnv.push_back(NOID);
+    khpv.push_back(NOID);
+    kcnxv.push_back(NOID);
+    kccnxv.push_back(NOID);
+    // the convex hull must be constructed
+    if (kch.empty()) {
+        return false;
+    }
+    bool on = insertVertex(iv);
+    stats += Statistics::collect();
+    return on;
+}
+
+/**
+ * Inserts vertices into the constructed convex hull
+ *  - vertices are inserted in order of the array,
+ *    the walk to the visible face starts from the last new face
+ * @param vertex array
+ * @return number of vertices on the convex hull
+ */
+ID ConvexHull::insert(const vector<Vector3d>& va) {
+    ID n = 0;
+    for_each(va.begin(), va.end(), [&](const Vector3d& v) {
+        if (insert(v)) {
+            n++;
+        }
+    });
+    return n;
+}
+
+/**
+ * Appends vertices to the convex hull of the stream in x order
+ *  - vertices after all former vertices in x order are constructed
+ *    into the convex hull and merged to the right side of it,
+ *    the others are inserted one by one, or the convex hull is
+ *    constructed again with them if they are many (the stream out of x order)
+ *  - vertices not on the convex hull are dropped, so that lists
+ *    are bounded by the convex hull and the chunk of vertices
+ *  - inputIndex() gives the index in the stream of each vertex
+ * @param vertex array
+ * @return appended, or too many vertices for ids
+ *         or vertices out of the range of the grid
+ */
+bool ConvexHull::append(const vector<Vector3d>& va) {
+    return append(VertexView(va.data(), va.size(), sizeof(Vector3d), VertexView::Type::FLOAT64));
+}
+
+/**
+ * Appends vertices of the view to the convex hull of the stream in x order
+ * @param vertex view
+ * @return appended, or too many vertices for ids
+ *         or vertices out of the range of the grid
+ */
+bool ConvexHull::append(const VertexView& vw) {
+    ID iv0 = numVertices();
+    if (vw.size() > (size_t)(NMAXV - iv0)) {
+        return false;
+    }
+    ID nv = vw.size();
+    hva.resize(3 * (iv0 + nv));
+    bool in = true;
+    for (ID i = 0; i < nv; i++) {
+        double v[3];
+        vw.get(i, v);
+        in &= snap(v, &hva[3*(iv0+i)]);
+    }
+    if (!in) {
+        hva.resize(3 * iv0);
+        return false;
+    }
+    appendVertices(iv0);
+    return true;
+}
+
+/**
+ * Inserts the vertex into the convex hull
+ *  - deletes faces visible from the vertex, edges between them
+ *    and vertices not on the horizon,
+ *    and connects the vertex to vertices on the horizon
+ * @param vertex
+ * @return the vertex is on the convex hull or not
+ */
+bool ConvexHull::insertVertex(ID iv) {
+    ictx.epoch++;
+    ictx.ndv = 0;
+    if (kep.size() < ker.size()) {
+        kep.resize(ker.size());
+    }
+    if (kfp.size() < kfe.size()) {
+        kfp.resize(kfe.size());
+    }
+    ID f0 = searchVisibleFace(iv);
+    if (f0 == NOID) {
+        return false;
+    }
+    
+    // searches visible faces, edges between them and edges on the horizon
+    vector<ID> kftd;
+    vector<ID> ketd;
+    vector<ID> keh;
+    setProperty(kfp, f0, PrimProperty::DELETE, ictx);
+    kftd.push_back(f0);
+    for (ID i = 0; i < (ID)kftd.size(); i++) {
+        ID f1 = kftd[i];
+        ID kv[3];
+        getVerticesOfTriangle(f1, kv);
+        for (int j = 0; j < 3; j++) {
+            if (equal(coord(kv[j]), coord(kv[j]) + 3, coord(iv))) {
+                // the vertex is duplicated on the grid
+                return false;
+            }
+        }
+        ID ke[3];
+        getEdgesOfTriangle(f1, ke);
+        for (int j = 0; j < 3; j++) {
+            ID e = ke[j];
+            if (property(kep, e, ictx) != PrimProperty::NOTDEFINED) {
+                continue;
+            }
+            ID f2 = (f1 == ker[e].rf ? ker[e].lf : ker[e].rf);
+            PrimProperty p = property(kfp, f2, ictx);
+            if (p == PrimProperty::DELETE) {
+                setProperty(kep, e, PrimProperty::DELETE, ictx);
+                ketd.push_back(e);
+            } else if (p == PrimProperty::NOTDEFINED && isFront(f2, iv)) {
+                // the edge is judged again from the other face
+                setProperty(kfp, f2, PrimProperty::DELETE, ictx);
+                kftd.push_back(f2);
+            } else {
+                setProperty(kfp, f2, PrimProperty::BOUNDARY, ictx);
+                setProperty(kep, e, PrimProperty::BOUNDARY, ictx);
+                keh.push_back(e);
+            }
+        }
+    }
+    
+    // searches vertices not on the horizon
+    //  - vertices on the horizon refer to edges on the horizon
+    for (ID i = 0; i < (ID)keh.size(); i++) {
+        kve[ker[keh[i]].sv] = keh[i];
+        kve[ker[keh[i]].ev] = keh[i];
+    }
+    vector<ID> kvtd;
+    for (ID i = 0; i < (ID)kftd.size(); i++) {
+        ID kv[3];
+        getVerticesOfTriangle(kftd[i], kv);
+        for (int j = 0; j < 3; j++) {
+            if (kve[kv[j]] != NOID && property(kep, kve[kv[j]], ictx) != PrimProperty::BOUNDARY) {
+                kvtd.push_back(kv[j]);
+                deleteVertex(kv[j]);
+            }
+        }
+    }
+    
+    // orients edges on the horizon along new faces
+    //  - the new face of the edge from hy to hx is (hy, hx, iv) counter-clockwise
+    ID nh = keh.size();
+    vector<ID> khy(nh);
+    vector<ID> khx(nh);
+    for (ID i = 0; i < nh; i++) {
+        const EdgeRecord& r = ker[keh[i]];
+        bool left = (property(kfp, r.lf, ictx) == PrimProperty::DELETE);
+        khy[i] = (left ? r.sv : r.ev);
+        khx[i] = (left ? r.ev : r.sv);
+    }
+    
+    // executes delete of primitives
+    deletePrimitives(kvtd, ketd, kftd, ictx);
+    
+    // connects vertices on the horizon to the vertex
+    for (ID i = 0; i < nh; i++) {
+        ID e = newEdge(ictx.pool);
+        ker[e].sv = khy[i];
+        ker[e].ev = iv;
+        kve[khy[i]] = e;
+    }
+    
+    // connects new faces to edges
+    ID f = NOID;
+    for (ID i = 0; i < nh; i++) {
+        ID e = keh[i];
+        ID ey = kve[khy[i]];
+        ID ex = kve[khx[i]];
+        f = newFace(ictx.pool);
+        kfe[f] = e;
+        ker[ey].rf   = f;
+        ker[ey].sce  = e;
+        ker[ey].ecce = ex;
+        ker[ex].lf   = f;
+        ker[ex].scce = e;
+        ker[ex].ece  = ey;
+        if (ker[e].sv == khy[i]) {
+            ker[e].lf   = f;
+            ker[e].scce = ey;
+            ker[e].ece  = ex;
+        } else {
+            ker[e].rf   = f;
+            ker[e].sce  = ex;
+            ker[e].ecce = ey;
+        }
+    }
+    releaseIds(ictx.pool);
+    lastf = f;
+    silset = false;
+    
+    // updates vertices
+    kve[iv] = kve[khy[0]];
+    ID hv = khy[0];
+    ID nv = khnv[hv];
+    khnv[hv] = iv;
+    khpv[iv] = hv;
+    khnv[iv] = nv;
+    khpv[nv] = iv;
+    // the left most vertex is deleted only by the new left most vertex
+    // (the new vertex of the same x is on the right of it on SoS, which orders by id)
+    ID n = kchnv[kch[0]] + 1 - ictx.ndv;
+    if (coord(iv)[0] < coord(kch[0])[0]) {
+        kch[0] = iv;
+    }
+    kchnv[kch[0]] = n;
+    return true;
+}
+
+/**
+ * Searches a face visible from the vertex
+ *  - walks from the last new face to the face whose cone from the center
+ *    contains the vertex, crossing an edge which separates the face
+ *    and the vertex chosen at random, so that the walk does not cycle
+ * @param vertex
+ * @return visible face, or NOID if the vertex is in the convex hull
+ */
+ID ConvexHull::searchVisibleFace(ID iv) {
+    if (!hcset) {
+        setCenter();
+    }
+    ID f = lastf;
+    if (f == NOID || f >= faceBound() || !isFace(f)) {
+        for (f = 0; f < faceBound() && !isFace(f); f++) {
+        }
+    }
+    // the center is the next id of vertices on SoS
+    ID kv[] = { numVertices(), NOID, NOID, iv };
+    const GRID* va[] = { hc, nullptr, nullptr, coord(iv) };
+    for (ID n = 0; n < faceBound(); n++) {
+        ID kfv[3];
+        getVerticesOfTriangle(f, kfv);
+        int kce[3];
+        int nce = 0;
+        for (int i = 0; i < 3; i++) {
+            // plane of the center and the edge of the face
+            kv[1] = kfv[i];
+            kv[2] = kfv[(i+1)%3];
+            va[1] = coord(kv[1]);
+            va[2] = coord(kv[2]);
+            kv[3] = kfv[(i+2)%3];
+            va[3] = coord(kv[3]);
+            bool s = Predicate::orient(kv, va);
+            kv[3] = iv;
+            va[3] = coord(iv);
+            if (Predicate::orient(kv, va) != s) {
+                kce[nce++] = i;
+            }
+        }
+        if (nce == 0) {
+            return (isFront(f, iv) ? f : NOID);
+        }
+        // crosses the edge to the adjacent face
+        int i = kce[rng() % nce];
+        ID ke[3];
+        getEdgesOfTriangle(f, ke);
+        ID e = NOID;
+        for (int j = 0; j < 3; j++) {
+            const EdgeRecord& r = ker[ke[j]];
+            if (r.sv + r.ev == kfv[i] + kfv[(i+1)%3] && (r.sv == kfv[i] || r.ev == kfv[i])) {
+                e = ke[j];
+            }
+        }
+        f = (ker[e].lf == f ? ker[e].rf : ker[e].lf);
+    }
+    // judges all faces if the walk is too long
+    for (f = 0; f < faceBound(); f++) {
+        if (isFace(f) && isFront(f, iv)) {
+            return f;
+        }
+    }
+    return NOID;
+}
+
+/**
+ * Appends vertices on the grid to the convex hull
+ *  - constructs the first convex hull when there are enough vertices
+ *  - the convex hull is cleared if merges are cancelled by the progress function
+ * @param first vertex to append
+ */
+void ConvexHull::appendVertices(ID iv0) {
+    ID n = numVertices() - iv0;
+    for (ID i = 0; i < n && (!kiv.empty() || nin != iv0); i++) {
+        kiv.push_back(nin + i);
+    }
+    nin += n;
+    cancelled = false;
+    if (kch.empty()) {
+        Statistics::reset();
+        stats.clear();
+        sortVertices(0);
+        constConvexHull();
+        if (cancelled) {
+            clear();
+            return;
+        }
+    } else {
+        sortVertices(iv0);
+        ID nv = numVertices();
+        kve.resize(nv, NOID);
+        kchnv.resize(nv, 0);
+        khnv.resize(nv, NOID);
+        khpv.resize(nv, NOID);
+        kcnxv.resize(nv, NOID);
+        kccnxv.resize(nv, NOID);
+        // searches vertices after the right most vertex of the convex hull
+        ID rv = searchRightMostVertex();
+        ID iv1 = iv0;
+        while (iv1 < nv && !lexicographical_compare(coord(rv), coord(rv) + 3, coord(iv1), coord(iv1) + 3)) {
+            iv1++;
+        }
+        ID iv2 = nv;
+        ID nov = iv1 - iv0;
+        if (nov >= NMINV && (INT64)nov * NRECONST >= (INT64)kchnv[kch[0]] + (nv - iv0)) {
+            // constructs the convex hull of its vertices and the chunk again
+            // if many vertices of the chunk overlap it in x order,
+            // which costs less than insertions of them one by one
+            GeoGraph::clear();
+            kch.clear();
+            kep.clear();
+            kfp.clear();
+            ictx.epoch = 0;
+            lastf = NOID;
+            hcset = false;
+            silset = false;
+            Statistics::reset();
+            stats.clear();
+            sortVertices(0);
+            constConvexHull();
+            if (cancelled) {
+                clear();
+                return;
+            }
+            iv2 = iv0;
+        } else if (nv - iv1 >= NMINV) {
+            // constructs the convex hull of them and merges it to the right side
+            ID liv0 = kch[0];
+            kch.clear();
+            constInitHulls(iv1);
+            ID nep = ictx.epoch;
+            mergeHulls(nep);
+            if (cancelled) {
+                clear();
+                return;
+            }
+            kep.resize(ker.size());
+            kfp.resize(kfe.size());
+            ictx.epoch = nep + 1;
+            merge2Hulls(liv0, kch[0], ictx);
+            kch.assign(1, liv0);
+            iv2 = iv1;
+        }
+        // inserts the others one by one
+        for (ID iv = iv0; iv < iv2; iv++) {
+            insertVertex(iv);
+        }
+    }
+    // drops vertices not on the convex hull
+    if (!kch.empty() && numVertices() > 2 * kchnv[kch[0]]) {
+        compactVertices();
+    }
+    stats += Statistics::collect();
+}
+
+/**
+ * Searches the right most vertex of the convex hull
+ *  - the vertex is on the silhouette, which is searched again
+ *    from the left most vertex after insertions
+ * @return right most vertex in x, y and z order
+ */
+ID ConvexHull::searchRightMostVertex() {
+    if (!silset) {
+        searchSilhouette(1, &kch[0]);
+        silset = true;
+    }
+    ID iv = kch[0];
+    ID rv = iv;
+    do {
+        iv = kcnxv[iv];
+        if (lexicographical_compare(coord(rv), coord(rv) + 3, coord(iv), coord(iv) + 3)) {
+            rv = iv;
+        }
+    } while (iv != kch[0]);
+    return rv;
+}
+
+/**
+ * Compacts ids of vertices
+ *  - drops vertices not on the convex hull in order of ids,
+ *    and renumbers vertices of edges and lists of vertices
+ */
+void ConvexHull::compactVertices() {
+    // maps old ids to new ids
+    ID nv = numVertices();
+    vector<ID> kvm(nv, NOID);
+    ID n = 0;
+    for (ID iv = 0; iv < nv; iv++) {
+        if (kve[iv] != NOID) {
+            kvm[iv] = n++;
+        }
+    }
+    auto map = [&](ID iv) {
+        return (iv != NOID ? kvm[iv] : NOID);
+    };
+    
+    // moves vertices and their lists
+    vector<ID> kiv0(n);
+    for (ID iv = 0; iv < nv; iv++) {
+        ID jv = kvm[iv];
+        if (jv != NOID) {
+            kiv0[jv] = inputIndex(iv);
+            copy(coord(iv), coord(iv) + 3, &hva[3*jv]);
+            kve[jv]    = kve[iv];
+            kchnv[jv]  = kchnv[iv];
+            khnv[jv]   = map(khnv[iv]);
+            khpv[jv]   = map(khpv[iv]);
+            kcnxv[jv]  = map(kcnxv[iv]);
+            kccnxv[jv] = map(kccnxv[iv]);
+        }
+    }
+    kiv.swap(kiv0);
+    hva.resize(3 * n);
+    kve.resize(n);
+    kchnv.resize(n);
+    khnv.resize(n);
+    khpv.resize(n);
+    kcnxv.resize(n);
+    kccnxv.resize(n);
+    for (ID i = 0; i < (ID)kch.size(); i++) {
+        kch[i] = kvm[kch[i]];
+    }
+    
+    // renumbers vertices of edges
+    for (ID e = 0; e < (ID)ker.size(); e++) {
+        if (ker[e].sv != NOID) {
+            ker[e].sv = kvm[ker[e].sv];
+            ker[e].ev = kvm[ker[e].ev];
+        }
+    }
+}
+
+/**
+ * Sets the center of the convex hull
+ *  - the average of vertices on the convex hull rounded on the grid,
+ *    which remains in the convex hull on insertions
+ */
+void ConvexHull::setCenter() {
+    double c[] = { 0.0, 0.0, 0.0 };
+    ID n = 0;
+    ID iv = kch[0];
+    do {
+        const GRID* g = coord(iv);
+        for (int k = 0; k < 3; k++) {
+            c[k] += g[k];
+        }
+        n++;
+        iv = khnv[iv];
+    } while (iv != kch[0]);
+    for (int k = 0; k < 3; k++) {
+        hc[k] = (GRID)llround(c[k] / n);
+    }
+    hcset = true;
+}
+
+/**
+ * Culls vertices in the polytope of extreme vertices (Akl-Toussaint)
+ *  - searches extreme vertices along directions on threads,
+ *    and faces of the polytope by all triangles of them
+ *  - judges blocks of vertices against faces in the floating point
+ *    with the error bound, so that only vertices strictly in the polytope
+ *    are culled, which are not on the convex hull
+ *  - keeps NMINV vertices at least, inputIndex() gives the index in the input
+ */
+void ConvexHull::cullVertices() {
+    STATS_TIMER(CULL_VERTICES);
+    ID nv = numVertices();
+    if (culling == Culling::NONE || nv < NCULL) {
+        return;
+    }
+    // directions of extreme vertices
+    vector<array<int, 3>> kd;
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dz = -1; dz <= 1; dz++) {
+                int n = (dx != 0) + (dy != 0) + (dz != 0);
+                if (n == 1 || (n > 1 && culling == Culling::POLYTOPE26)) {
+                    kd.push_back({ { dx, dy, dz } });
+                }
+            }
+        }
+    }
+    int nd = kd.size();
+    auto dot = [&](int j, ID iv) {
+        const GRID* g = coord(iv);
+        return kd[j][0] * (INT64)g[0] + kd[j][1] * (INT64)g[1] + kd[j][2] * (INT64)g[2];
+    };
+    
+    // searches extreme vertices on threads
+    int nt = max(1, (int)min<ID>(nthr, nv / NCULL));
+    vector<ID> kev(nt * nd, 0);
+    runTasks(nt, [&](int t) {
+        ID i0 = (long long)nv * t / nt;
+        ID i1 = (long long)nv * (t + 1) / nt;
+        ID* ke = &kev[t*nd];
+        for (int j = 0; j < nd; j++) {
+            ke[j] = i0;
+        }
+        for (ID i = i0 + 1; i < i1; i++) {
+            for (int j = 0; j < nd; j++) {
+                if (dot(j, i) > dot(j, ke[j])) {
+                    ke[j] = i;
+                }
+            }
+        }
+    });
+    for (int t = 1; t < nt; t++) {
+        for (int j = 0; j < nd; j++) {
+            if (dot(j, kev[t*nd+j]) > dot(j, kev[j])) {
+                kev[j] = kev[t*nd+j];
+            }
+        }
+    }
+    // span of vertices in each axis bounds differences of coordinates
+    double span[3];
+    for (int k = 0; k < 3; k++) {
+        INT64 lo = INT64_MAX;
+        INT64 hi = INT64_MIN;
+        for (int j = 0; j < nd; j++) {
+            lo = min(lo, (INT64)coord(kev[j])[k]);
+            hi = max(hi, (INT64)coord(kev[j])[k]);
+        }
+        span[k] = (double)(hi - lo);
+    }
+    kev.resize(nd);
+    sort(kev.begin(), kev.end());
+    kev.erase(unique(kev.begin(), kev.end()), kev.end());
+    
+    // searches faces of the polytope of extreme vertices
+    //  - the plane of the face has all extreme vertices behind or on it
+    struct Plane {
+        double n[3];        // outward normal
+        double a[3];        // vertex on the plane
+        double b;           // error bound
+    };
+    vector<Plane> kpl;
+    int ne = kev.size();
+    for (int i = 0; i < ne; i++) {
+        for (int j = i + 1; j < ne; j++) {
+            for (int k = j + 1; k < ne; k++) {
+                const GRID* a = coord(kev[i]);
+                const GRID* b = coord(kev[j]);
+                const GRID* c = coord(kev[k]);
+                INT128 u[] = { (INT128)b[0] - a[0], (INT128)b[1] - a[1], (INT128)b[2] - a[2] };
+                INT128 v[] = { (INT128)c[0] - a[0], (INT128)c[1] - a[1], (INT128)c[2] - a[2] };
+                INT128 n[] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+                int npos = 0, nneg = 0;
+                for (int l = 0; l < ne; l++) {
+                    const GRID* q = coord(kev[l]);
+                    INT128 d = n[0] * ((INT128)q[0] - a[0]) + n[1] * ((INT128)q[1] - a[1]) + n[2] * ((INT128)q[2] - a[2]);
+                    npos += (d > 0);
+                    nneg += (d < 0);
+                }
+                if ((npos == 0) == (nneg == 0)) {
+                    // extreme vertices on both sides, or all on the plane
+                    continue;
+                }
+                double sg = (npos == 0 ? 1.0 : -1.0);
+                Plane pl;
+                pl.b = 0.0;
+                for (int l = 0; l < 3; l++) {
+                    pl.n[l] = sg * (double)n[l];
+                    pl.a[l] = (double)a[l];
+                    pl.b += CULLEPS * fabs(pl.n[l]) * span[l];
+                }
+                kpl.push_back(pl);
+            }
+        }
+    }
+    if (kpl.empty()) {
+        return;
+    }
+    
+    // judges blocks of vertices on threads
+    int np = kpl.size();
+    vector<char> kin(nv);
+    nt = max(1, (int)min<ID>(nthr, nv / NCULL));
+    runTasks(nt, [&](int t) {
+        ID i0 = (long long)nv * t / nt;
+        ID i1 = (long long)nv * (t + 1) / nt;
+        double x[NCBLK], y[NCBLK], z[NCBLK];
+        char in[NCBLK];
+        for (ID i = i0; i < i1; i += NCBLK) {
+            int n = (int)min<ID>(NCBLK, i1 - i);
+            const GRID* g = coord(i);
+            for (int l = 0; l < n; l++) {
+                x[l] = (double)g[3*l];
+                y[l] = (double)g[3*l+1];
+                z[l] = (double)g[3*l+2];
+                in[l] = 1;
+            }
+            for (int p = 0; p < np; p++) {
+                const Plane& pl = kpl[p];
+                for (int l = 0; l < n; l++) {
+                    double d = pl.n[0] * (x[l] - pl.a[0]) + pl.n[1] * (y[l] - pl.a[1]) + pl.n[2] * (z[l] - pl.a[2]);
+                    in[l] &= (d < -pl.b);
+                }
+            }
+            memcpy(&kin[i], in, n);
+        }
+    });
+    
+    // gathers vertices out of the polytope
+    ID nout = count(kin.begin(), kin.end(), 0);
+    ID nkeep = max<ID>(0, NMINV - nout);
+    vector<ID> kiv0;
+    kiv0.reserve(nout + nkeep);
+    ID n = 0;
+    for (ID i = 0; i < nv; i++) {
+        if (kin[i] == 0 || nkeep > 0) {
+            nkeep -= kin[i];
+            copy(coord(i), coord(i) + 3, &hva[3*n]);
+            kiv0.push_back(inputIndex(i));
+            n++;
+        }
+    }
+    hva.resize(3 * n);
+    kiv.swap(kiv0);
+}
+
+/**
+ * Sorts vertices on the grid in x order and removes duplicates
+ *  - does nothing if vertices are already in x order and distinct
+ *  - sorts pairs of x and index in the contiguous array by the sample sort
+ *    on threads, vertices of the same x are in y and z order
+ *  - inputIndex() gives the index in the input of each vertex
+ * @param first vertex to sort, vertices before it remain as they are
+ */
+void ConvexHull::sortVertices(ID iv0) {
+    STATS_TIMER(SORT_VERTICES);
+    ID nv = hva.size() / 3;
+    auto less = [&](ID i, ID j) {
+        return lexicographical_compare(&hva[3*i], &hva[3*i+3], &hva[3*j], &hva[3*j+3]);
+    };
+    ID i0 = iv0 + 1;
+    while (i0 < nv && less(i0 - 1, i0)) {
+        i0++;
+    }
+    if (i0 >= nv) {
+        return;
+    }
+    // pairs of x and index, in x, y, z and index order
+    typedef pair<GRID, ID> XPair;
+    auto lessx = [&](const XPair& a, const XPair& b) {
+        if (a.first != b.first) {
+            return a.first < b.first;
+        }
+        return (less(a.second, b.second) || (!less(b.second, a.second) && a.second < b.second));
+    };
+    ID m = nv - iv0;
+    int nt = max(1, (int)min<ID>(nthr, m / NSORT));
+    vector<XPair> kx(m);
+    runTasks(nt, [&](int t) {
+        for (ID i = (long long)m * t / nt; i < (long long)m * (t + 1) / nt; i++) {
+            kx[i] = make_pair(hva[3*(iv0+i)], iv0 + i);
+        }
     });
+    if (nt == 1) {
+        sort(kx.begin(), kx.end(), lessx);
+    } else {
+        // splits pairs into buckets by splitters of samples
+        vector<XPair> ks(nt * NSAMPLE);
+        for (int i = 0; i < (int)ks.size(); i++) {
+            ks[i] = kx[(long long)m * i / ks.size()];
+        }
+        sort(ks.begin(), ks.end(), lessx);
+        vector<XPair> ksp(nt - 1);
+        for (int b = 0; b < nt - 1; b++) {
+            ksp[b] = ks[(b + 1) * NSAMPLE];
+        }
+        auto bucket = [&](const XPair& x) {
+            return (int)(upper_bound(ksp.begin(), ksp.end(), x, lessx) - ksp.begin());
+        };
+        // counts pairs of each bucket on each thread
+        vector<ID> kofs(nt * nt, 0);
+        runTasks(nt, [&](int t) {
+            for (ID i = (long long)m * t / nt; i < (long long)m * (t + 1) / nt; i++) {
+                kofs[t*nt+bucket(kx[i])]++;
+            }
+        });
+        // offsets of buckets of each thread
+        vector<ID> kbs(nt + 1, 0);
+        ID n = 0;
+        for (int b = 0; b < nt; b++) {
+            kbs[b] = n;
+            for (int t = 0; t < nt; t++) {
+                ID c = kofs[t*nt+b];
+                kofs[t*nt+b] = n;
+                n += c;
+            }
+        }
+        kbs[nt] = n;
+        // scatters pairs to buckets and sorts each bucket
+        vector<XPair> ky(m);
+        runTasks(nt, [&](int t) {
+            for (ID i = (long long)m * t / nt; i < (long long)m * (t + 1) / nt; i++) {
+                ky[kofs[t*nt+bucket(kx[i])]++] = kx[i];
+            }
+        });
+        runTasks(nt, [&](int t) {
+            sort(ky.begin() + kbs[t], ky.begin() + kbs[t+1], lessx);
+        });
+        kx.swap(ky);
+    }
+    
+    // gathers distinct vertices in x order on threads
+    auto distinct = [&](ID i) {
+        return (i == 0 || !equal(&hva[3*kx[i].second], &hva[3*kx[i].second+3], &hva[3*kx[i-1].second]));
+    };
+    vector<ID> kn(nt + 1, 0);
+    runTasks(nt, [&](int t) {
+        for (ID i = (long long)m * t / nt; i < (long long)m * (t + 1) / nt; i++) {
+            kn[t+1] += distinct(i);
+        }
+    });
+    for (int t = 0; t < nt; t++) {
+        kn[t+1] += kn[t];
+    }
+    vector<GRID> hva0(3 * (iv0 + kn[nt]));
+    vector<ID> kiv0(iv0 + kn[nt]);
+    copy(hva.begin(), hva.begin() + 3 * iv0, hva0.begin());
+    for (ID i = 0; i < iv0; i++) {
+        kiv0[i] = inputIndex(i);
+    }
+    runTasks(nt, [&](int t) {
+        ID n = iv0 + kn[t];
+        for (ID i = (long long)m * t / nt; i < (long long)m * (t + 1) / nt; i++) {
+            if (distinct(i)) {
+                copy(&hva[3*kx[i].second], &hva[3*kx[i].second+3], &hva0[3*n]);
+                // index in the input through the former order
+                kiv0[n++] = inputIndex(kx[i].second);
+            }
+        }
+    });
+    kiv.swap(kiv0);
+    hva.swap(hva0);
+}
+
+/**
+ * Constructs the 3d convex hull of the vertex array
+ *  - the convex hull is empty if there are less than NMINV vertices
+ */
+void ConvexHull::constConvexHull() {
+    // allocates lists of vertices
+    ID nv = numVertices();
+    if (nv < NMINV) {
+        stats += Statistics::collect();
+        return;
+    }
+    initVertices(nv);
+    kchnv.assign(nv, 0);
+    khnv.assign(nv, NOID);
+    khpv.assign(nv, NOID);
+    kcnxv.assign(nv, NOID);
+    kccnxv.assign(nv, NOID);
     // constructs initial convex hulls
-    constInitHulls();
+    reportProgress();
+    if (!cancelled) {
+        constInitHulls(0);
+    }
     // merges all convex hulls
-    mergeAllHulls();
+    if (!cancelled) {
+        mergeAllHulls();
+    }
+    // collects counters and timers of the calling thread,
+    // those of other threads are collected at the end of their tasks
+    stats += Statistics::collect();
 }
 
 /**
  * Constructs initial convex hulls
+ * @param first vertex of initial convex hulls
  */
-void ConvexHull::constInitHulls() {
-    int nv = hva.size();
-    int ntv = nv - (NDV - (nv - 1) % NTV) * NDV;
+void ConvexHull::constInitHulls(ID iv0) {
+    STATS_TIMER(CONST_INIT_HULLS);
+    ID nv = numVertices();
+    ID ntv = nv - (NDV - (nv - iv0 - 1) % NTV) * NDV;
     // constructs tetrahedra
-    for (int i = 0; i < ntv; i += NTV) {
+    for (ID i = iv0; i < ntv; i += NTV) {
         constTetrahedron(i);
     }
     // constructs dihedra
-    for (int i = ntv; i < nv; i += NDV) {
+    for (ID i = ntv; i < nv; i += NDV) {
         constDihedron(i);
     }
 }
@@ -72,24 +1032,23 @@ void ConvexHull::constInitHulls() {
  * Constructs the tetrahedron
  * @param vertex of the tetrahedron
  */
-void ConvexHull::constTetrahedron(int iv) {
-    int kv[] = { iv, iv+1, iv+2, iv+3 };
-    Vector3d va[] = { hva[kv[0]], hva[kv[1]], hva[kv[2]], hva[kv[3]] };
-    if (determ(kv, va)) {
+void ConvexHull::constTetrahedron(ID iv) {
+    ID kv[] = { iv, iv+1, iv+2, iv+3 };
+    if (isFront(kv)) {
         kv[2] = iv + 3;
         kv[3] = iv + 2;
     }
     
     // entries cyclic list of vertices
     for (int i = 0; i < NTV; i++) {
-        int nxv = kv[(i+1)%NTV];
+        ID nxv = kv[(i+1)%NTV];
         khnv[kv[i]] = nxv;
         khpv[nxv]  = kv[i];
     }
     
     // gets index of new edges and faces
-    int ke[] = { newEdge(), newEdge(), newEdge(), newEdge(), newEdge(), newEdge() };
-    int kf[] = { newFace(), newFace(), newFace(), newFace() };
+    ID ke[] = { newEdge(), newEdge(), newEdge(), newEdge(), newEdge(), newEdge() };
+    ID kf[] = { newFace(), newFace(), newFace(), newFace() };
     
     // connects faces to edges
     kfe[kf[0]] = ke[0];
@@ -104,81 +1063,82 @@ void ConvexHull::constTetrahedron(int iv) {
     kve[kv[3]] = ke[4];
     
     // connects edges to start and end vertices
-    ksv[ke[0]] = kv[1];
-    ksv[ke[1]] = kv[2];
-    ksv[ke[2]] = kv[3];
-    ksv[ke[3]] = kv[1];
-    ksv[ke[4]] = kv[2];
-    ksv[ke[5]] = kv[3];
-    kev[ke[0]] = kv[0];
-    kev[ke[1]] = kv[0];
-    kev[ke[2]] = kv[0];
-    kev[ke[3]] = kv[2];
-    kev[ke[4]] = kv[3];
-    kev[ke[5]] = kv[1];
+    ker[ke[0]].sv   = kv[1];
+    ker[ke[1]].sv   = kv[2];
+    ker[ke[2]].sv   = kv[3];
+    ker[ke[3]].sv   = kv[1];
+    ker[ke[4]].sv   = kv[2];
+    ker[ke[5]].sv   = kv[3];
+    ker[ke[0]].ev   = kv[0];
+    ker[ke[1]].ev   = kv[0];
+    ker[ke[2]].ev   = kv[0];
+    ker[ke[3]].ev   = kv[2];
+    ker[ke[4]].ev   = kv[3];
+    ker[ke[5]].ev   = kv[1];
     
     // connects edges to left and right faces
-    klf[ke[0]] = kf[2];
-    klf[ke[1]] = kf[0];
-    klf[ke[2]] = kf[1];
-    klf[ke[3]] = kf[0];
-    klf[ke[4]] = kf[1];
-    klf[ke[5]] = kf[2];
-    krf[ke[0]] = kf[0];
-    krf[ke[1]] = kf[1];
-    krf[ke[2]] = kf[2];
-    krf[ke[3]] = kf[3];
-    krf[ke[4]] = kf[3];
-    krf[ke[5]] = kf[3];
+    ker[ke[0]].lf   = kf[2];
+    ker[ke[1]].lf   = kf[0];
+    ker[ke[2]].lf   = kf[1];
+    ker[ke[3]].lf   = kf[0];
+    ker[ke[4]].lf   = kf[1];
+    ker[ke[5]].lf   = kf[2];
+    ker[ke[0]].rf   = kf[0];
+    ker[ke[1]].rf   = kf[1];
+    ker[ke[2]].rf   = kf[2];
+    ker[ke[3]].rf   = kf[3];
+    ker[ke[4]].rf   = kf[3];
+    ker[ke[5]].rf   = kf[3];
 
     // connects edges to contiguous edges
-    ksce[ke[0]]  = ke[3];
-    ksce[ke[1]]  = ke[4];
-    ksce[ke[2]]  = ke[5];
-    ksce[ke[3]]  = ke[5];
-    ksce[ke[4]]  = ke[3];
-    ksce[ke[5]]  = ke[4];
-    kscce[ke[0]] = ke[5];
-    kscce[ke[1]] = ke[3];
-    kscce[ke[2]] = ke[4];
-    kscce[ke[3]] = ke[0];
-    kscce[ke[4]] = ke[1];
-    kscce[ke[5]] = ke[2];
-    kece[ke[0]]  = ke[2];
-    kece[ke[1]]  = ke[0];
-    kece[ke[2]]  = ke[1];
-    kece[ke[3]]  = ke[1];
-    kece[ke[4]]  = ke[2];
-    kece[ke[5]]  = ke[0];
-    kecce[ke[0]] = ke[1];
-    kecce[ke[1]] = ke[2];
-    kecce[ke[2]] = ke[0];
-    kecce[ke[3]] = ke[4];
-    kecce[ke[4]] = ke[5];
-    kecce[ke[5]] = ke[3];
+    ker[ke[0]].sce  = ke[3];
+    ker[ke[1]].sce  = ke[4];
+    ker[ke[2]].sce  = ke[5];
+    ker[ke[3]].sce  = ke[5];
+    ker[ke[4]].sce  = ke[3];
+    ker[ke[5]].sce  = ke[4];
+    ker[ke[0]].scce = ke[5];
+    ker[ke[1]].scce = ke[3];
+    ker[ke[2]].scce = ke[4];
+    ker[ke[3]].scce = ke[0];
+    ker[ke[4]].scce = ke[1];
+    ker[ke[5]].scce = ke[2];
+    ker[ke[0]].ece  = ke[2];
+    ker[ke[1]].ece  = ke[0];
+    ker[ke[2]].ece  = ke[1];
+    ker[ke[3]].ece  = ke[1];
+    ker[ke[4]].ece  = ke[2];
+    ker[ke[5]].ece  = ke[0];
+    ker[ke[0]].ecce = ke[1];
+    ker[ke[1]].ecce = ke[2];
+    ker[ke[2]].ecce = ke[0];
+    ker[ke[3]].ecce = ke[4];
+    ker[ke[4]].ecce = ke[5];
+    ker[ke[5]].ecce = ke[3];
     
     // entries cyclic list of vertices on the silhouette of the convex hull
     // entries a left most vertex
     kch.push_back(searchSilhouette(NTV, kv));
+    kchnv[kch.back()] = NTV;
 }
 
 /**
  * Constructs the dihedron
  * @param vertex the dihedron
  */
-void ConvexHull::constDihedron(int iv) {
-    int kv[] = { iv, iv+1, iv+2 };
+void ConvexHull::constDihedron(ID iv) {
+    ID kv[] = { iv, iv+1, iv+2 };
     
     // entries cyclic list of vertices
     for (int i = 0; i < NDV; i++) {
-        int nxv = kv[(i+1)%NDV];
+        ID nxv = kv[(i+1)%NDV];
         khnv[kv[i]] = nxv;
         khpv[nxv]  = kv[i];
     }
     
     // gets index of new edges and faces
-    int ke[] = { newEdge(), newEdge(), newEdge() };
-    int kf[] = { newFace(), newFace() };
+    ID ke[] = { newEdge(), newEdge(), newEdge() };
+    ID kf[] = { newFace(), newFace() };
     
     // connects faces to edges
     kfe[kf[0]] = ke[0];
@@ -190,38 +1150,39 @@ void ConvexHull::constDihedron(int iv) {
     kve[kv[2]] = ke[2];
     
     // connects edges to start and end vertices
-    ksv[ke[0]] = kv[0];
-    ksv[ke[1]] = kv[1];
-    ksv[ke[2]] = kv[2];
-    kev[ke[0]] = kv[1];
-    kev[ke[1]] = kv[2];
-    kev[ke[2]] = kv[0];
+    ker[ke[0]].sv   = kv[0];
+    ker[ke[1]].sv   = kv[1];
+    ker[ke[2]].sv   = kv[2];
+    ker[ke[0]].ev   = kv[1];
+    ker[ke[1]].ev   = kv[2];
+    ker[ke[2]].ev   = kv[0];
     
     // connects edges to left and right faces
-    klf[ke[0]] = kf[1];
-    klf[ke[1]] = kf[1];
-    klf[ke[2]] = kf[1];
-    krf[ke[0]] = kf[0];
-    krf[ke[1]] = kf[0];
-    krf[ke[2]] = kf[0];
+    ker[ke[0]].lf   = kf[1];
+    ker[ke[1]].lf   = kf[1];
+    ker[ke[2]].lf   = kf[1];
+    ker[ke[0]].rf   = kf[0];
+    ker[ke[1]].rf   = kf[0];
+    ker[ke[2]].rf   = kf[0];
 
     // connects edges to contiguous edges
-    ksce[ke[0]]  = ke[2];
-    ksce[ke[1]]  = ke[0];
-    ksce[ke[2]]  = ke[1];
-    kscce[ke[0]] = ke[2];
-    kscce[ke[1]] = ke[0];
-    kscce[ke[2]] = ke[1];
-    kece[ke[0]]  = ke[1];
-    kece[ke[1]]  = ke[2];
-    kece[ke[2]]  = ke[0];
-    kecce[ke[0]] = ke[1];
-    kecce[ke[1]] = ke[2];
-    kecce[ke[2]] = ke[0];
+    ker[ke[0]].sce  = ke[2];
+    ker[ke[1]].sce  = ke[0];
+    ker[ke[2]].sce  = ke[1];
+    ker[ke[0]].scce = ke[2];
+    ker[ke[1]].scce = ke[0];
+    ker[ke[2]].scce = ke[1];
+    ker[ke[0]].ece  = ke[1];
+    ker[ke[1]].ece  = ke[2];
+    ker[ke[2]].ece  = ke[0];
+    ker[ke[0]].ecce = ke[1];
+    ker[ke[1]].ecce = ke[2];
+    ker[ke[2]].ecce = ke[0];
     
     // entries cyclic list of vertices on the silhouette of the convex hull
     // entries a left most vertex
     kch.push_back(searchSilhouette(NDV, kv));
+    kchnv[kch.back()] = NDV;
 }
 
 /**
@@ -230,34 +1191,24 @@ void ConvexHull::constDihedron(int iv) {
  * @param vertices
  * @return left most vertex on the silhouette of the convex hull
  */
-int ConvexHull::searchSilhouette(int nv, int* kv0) {
-    int iv0 = 0;
-    for (int i = 0; i < nv; i++) {
+ID ConvexHull::searchSilhouette(ID nv, ID* kv0) {
+    STATS_TIMER(SEARCH_SILHOUETTE);
+    ID iv0 = 0;
+    for (ID i = 0; i < nv; i++) {
         iv0 = kv0[i];
-        int iv = iv0;
+        ID iv = iv0;
         bool found = false;
         do {
-            int e0 = kve[iv];
-            int e = e0;
-            bool or2 = isFront(rightFace(iv, e));
-            found = false;
-            do {
-                bool or1 = isFront(leftFace(iv, e));
-                // if the silhouette edge is found, entries vertex to cyclic list
-                if (!or1 && or2) {
-                    int nxv = otherVertex(iv, e);
-                    kcnxv[iv] = nxv;
-                    kccnxv[nxv] = iv;
-                    iv = nxv;
-                    found = true;
-                    break;
-                }
-                e = nextCCWEdge(iv, e);
-                or2 = or1;
-            } while (e != e0);
+            ID e = searchRidgeEdge(iv, NOID, ScanDir::CCW);
+            found = (e != NOID);
             if (!found) {
                 break;
             }
+            // if the silhouette edge is found, entries vertex to cyclic list
+            ID nxv = otherVertex(iv, e);
+            kcnxv[iv] = nxv;
+            kccnxv[nxv] = iv;
+            iv = nxv;
         } while (iv != iv0);
         if (found) {
             break;
@@ -272,38 +1223,215 @@ int ConvexHull::searchSilhouette(int nv, int* kv0) {
  * Merges all convex hulls
  */
 void ConvexHull::mergeAllHulls() {
-    int nch = kch.size();
+    ID nep = 0;
+    mergeHulls(nep);
+    if (cancelled) {
+        return;
+    }
+    silset = true;
+    // releases properties and compacts ids of edges and faces
+    kep.clear();
+    kep.shrink_to_fit();
+    kfp.clear();
+    kfp.shrink_to_fit();
+    compact();
+}
+
+/**
+ * Merges convex hulls in the index into 1 convex hull
+ * @param epoch of the last merge
+ */
+void ConvexHull::mergeHulls(ID& nep) {
+    reportProgress();
+    // merges convex hulls on each thread depth first
+    if (order == MergeOrder::DEPTH_FIRST && !cancelled) {
+        mergeDepthFirst(nep);
+        reportProgress();
+    }
+    // merges remaining convex hulls breadth first
+    mergeBreadthFirst(nep);
+}
+
+/**
+ * Merges convex hulls level by level
+ *  - merges of a level are on disjoint convex hulls,
+ *    so that they run concurrently on nthr threads
+ * @param epoch of the last merge
+ */
+void ConvexHull::mergeBreadthFirst(ID& nep) {
+    ID nch = kch.size();
     // computes until the 1 convex hull
-    while (nch > 1) {
+    while (nch > 1 && !cancelled) {
+        ID nm = nch / 2;
+        int nt = (int)min<ID>(nthr, nm);
+        vector<MergeContext> kctx(nt);
+        // reserves ids of edges and faces for each thread
+        // (the merge of convex hulls of nvl and nvr vertices wraps them in the cylinder
+        //  of faces of the merged convex hull before it deletes anything,
+        //  the wrap may visit vertices of flat convex hulls more than once,
+        //  but the merged convex hull has at most 3 * (nvl + nvr) edges
+        //  and 2 * (nvl + nvr) faces, and deleted ids return to the pool
+        //  before the next merge)
+        for (int t = 0; t < nt; t++) {
+            ID n = 0;
+            for (ID i = nm * t / nt; i < nm * (t + 1) / nt; i++) {
+                n += kchnv[kch[2*i]] + kchnv[kch[2*i+1]];
+            }
+            initContext(kctx[t], (nt > 1 ? 3 * n : 0), (nt > 1 ? 2 * n : 0));
+        }
         // initializes property of edges and faces
-        initProperty();
+        // (each merge has its own epoch, so that properties of former merges are NOTDEFINED)
+        kep.resize(ker.size());
+        kfp.resize(kfe.size());
         // merges 2 adjacent convex hulls
-        for (int i = 0; i < (nch - 1); i += 2) {
-            merge2Hulls(kch[i], kch[i+1]);
+        runTasks(nt, [&](int t) {
+            for (ID i = nm * t / nt; i < nm * (t + 1) / nt; i++) {
+                kctx[t].epoch = nep + i + 1;
+                merge2Hulls(kch[2*i], kch[2*i+1], kctx[t]);
+            }
+        });
+        for (int t = 0; t < nt; t++) {
+            releaseIds(kctx[t].pool);
         }
+        nep += nm;
         // deletes index of merged convex hulls
-        int ir = (nch % 2 == 0 ? nch-1 : nch-2);
-        vector<int>::iterator head = kch.begin();
-        for (int i = ir; i >= 0; i -= 2) {
-            kch.erase(head+i);
+        for (ID i = 0; i < nch; i += 2) {
+            kch[i/2] = kch[i];
         }
+        kch.resize((nch + 1) / 2);
         nch = kch.size();
+        reportProgress();
     }
 }
 
 /**
- * Initializes property of edges and faces
+ * Merges convex hulls depth first
+ *  - merges the block of adjacent convex hulls on each thread,
+ *    so that small convex hulls are merged while they are in the cache
+ *  - leaves 1 convex hull per thread
+ * @param epoch of the last merge
  */
-void ConvexHull::initProperty() {
-    kep.clear();
-    for_each(ksv.begin(), ksv.end(), [this](unordered_map<int, int>::value_type k) {
-        kep[k.first] = PrimProperty::NOTDEFINED;
+void ConvexHull::mergeDepthFirst(ID& nep) {
+    ID nch = kch.size();
+    int nt = (int)min<ID>(nthr, nch);
+    vector<MergeContext> kctx(nt);
+    // reserves ids of edges and faces for each thread
+    // (convex hulls of the block of nv vertices in total have at most
+    //  3 * nv edges and 2 * nv faces alive at any time, the merge makes
+    //  at most 3 * nv more edges and 2 * nv more faces of the merged convex hull
+    //  before it deletes non convex hull ones, and ne edges and nf faces
+    //  of the initial convex hulls have ids already,
+    //  so that the block needs at most 6 * nv - ne edges and 4 * nv - nf faces)
+    for (int t = 0; t < nt; t++) {
+        ID nv = 0, ne = 0, nf = 0;
+        for (ID i = nch * t / nt; i < nch * (t + 1) / nt; i++) {
+            nv += kchnv[kch[i]];
+            ne += 3 * kchnv[kch[i]] - 6;
+            nf += 2 * kchnv[kch[i]] - 4;
+        }
+        initContext(kctx[t], (nt > 1 ? 6 * nv - ne : 0), (nt > 1 ? 4 * nv - nf : 0));
+        kctx[t].epoch = nep + nch * t / nt;
+    }
+    kep.resize(ker.size());
+    kfp.resize(kfe.size());
+    runTasks(nt, [&](int t) {
+        mergeRange(nch * t / nt, nch * (t + 1) / nt, kctx[t]);
     });
+    for (int t = 0; t < nt; t++) {
+        releaseIds(kctx[t].pool);
+    }
+    nep += nch;
+    // leaves index of merged convex hulls
+    for (int t = 0; t < nt; t++) {
+        kch[t] = kch[nch * t / nt];
+    }
+    kch.resize(nt);
+}
 
-    kfp.clear();
-    for_each(kfe.begin(), kfe.end(), [this](unordered_map<int, int>::value_type k) {
-        kfp[k.first] = PrimProperty::NOTDEFINED;
+/**
+ * Merges the range of convex hulls recursively
+ * @param first convex hull
+ * @param last convex hull (not included)
+ * @param context of merges
+ */
+void ConvexHull::mergeRange(ID ich0, ID ich1, MergeContext& ctx) {
+    if (ich1 - ich0 < 2) {
+        return;
+    }
+    ID ich = (ich0 + ich1) / 2;
+    mergeRange(ich0, ich, ctx);
+    mergeRange(ich, ich1, ctx);
+    ctx.epoch++;
+    merge2Hulls(kch[ich0], kch[ich], ctx);
+}
+
+/**
+ * Initializes the context of merges
+ *  - ids reserved for the context are allocated only by merges of the context,
+ *    or ids are allocated from the free list directly if nothing is reserved
+ * @param context of merges
+ * @param number of edges to reserve
+ * @param number of faces to reserve
+ */
+void ConvexHull::initContext(MergeContext& ctx, ID ne, ID nf) {
+    ctx.epoch = 0;
+    ctx.ndv = 0;
+    reserveIds(ctx.pool, ne, nf);
+}
+
+/**
+ * Reports number of remaining convex hulls
+ *  - cancels the construction if the function returns false
+ */
+void ConvexHull::reportProgress() {
+    if (progress && !cancelled && !progress(kch.size())) {
+        cancelled = true;
+    }
+}
+
+/**
+ * Runs tasks on threads
+ *  - the first task runs on the calling thread
+ *  - counters and timers of other threads are collected into this convex hull
+ * @param number of tasks
+ * @param task
+ */
+void ConvexHull::runTasks(int n, const function<void(int)>& task) {
+    vector<thread> kth;
+    vector<Statistics::Record> krec(n);
+    for (int t = 1; t < n; t++) {
+        kth.push_back(thread([&task, &krec, t]() {
+            task(t);
+            krec[t] = Statistics::collect();
+        }));
+    }
+    if (n > 0) {
+        task(0);
+    }
+    for_each(kth.begin(), kth.end(), [](thread& th) {
+        th.join();
     });
+    // counters of threads belong to this convex hull
+    for (int t = 1; t < n; t++) {
+        stats += krec[t];
+    }
+}
+
+/**
+ * Sets property of the primitive on the merge
+ *  - grows the list of properties only on 1 thread,
+ *    ids of concurrent merges are in the list from the start of the level
+ * @param list of properties
+ * @param primitive
+ * @param property
+ * @param context of the merge
+ */
+void ConvexHull::setProperty(vector<PrimStamp>& kp, ID k, PrimProperty p, const MergeContext& ctx) {
+    if (k >= (ID)kp.size()) {
+        kp.resize(k + 1);
+    }
+    kp[k].epoch = ctx.epoch;
+    kp[k].prop = p;
 }
 
 /**
@@ -311,18 +1439,21 @@ void ConvexHull::initProperty() {
  * @param vertex of the left convex hull
  * @param vertex of the right convex hull
  */
-void ConvexHull::merge2Hulls(int liv0, int riv0) {
-    int liv = liv0;
-    int livr = liv0;
+void ConvexHull::merge2Hulls(ID liv0, ID riv0, MergeContext& ctx) {
+    ctx.ndv = 0;
+    ID liv = liv0;
+    ID livr = liv0;
     // searches the right most vertex of the left convex hull
+    // (vertices of the same x are ordered by id on SoS)
     do {
         liv = kcnxv[liv];
-        if (hva[livr].x() < hva[liv].x()) {
+        if (coord(livr)[0] < coord(liv)[0] ||
+            (coord(livr)[0] == coord(liv)[0] && livr < liv)) {
             livr = liv;
         }
     } while (liv != liv0);
-    int liv1 = livr;  int liv2 = livr;
-    int riv1 = riv0;  int riv2 = riv0;
+    ID liv1 = livr;  ID liv2 = livr;
+    ID riv1 = riv0;  ID riv2 = riv0;
     // searches the common tangent edge
     searchCTEdge(liv1, kccnxv, riv1, kcnxv , false);
     searchCTEdge(liv2, kcnxv , riv2, kccnxv, true);
@@ -330,17 +1461,23 @@ void ConvexHull::merge2Hulls(int liv0, int riv0) {
     kccnxv[riv1] = liv1;
     kcnxv[riv2]  = liv2;
     kccnxv[liv2] = riv2;
-    int cte = newEdge();
-    ksv[cte] = liv1;
-    kev[cte] = riv1;
-    kep[cte] = PrimProperty::NEW;
+    ID cte = newEdge(ctx.pool);
+    ker[cte].sv = liv1;
+    ker[cte].ev = riv1;
+    setProperty(kep, cte, PrimProperty::NEW, ctx);
     // wraps 2 convex hulls in cylindrical
-    wrapInCylindrical(cte);
+    wrapInCylindrical(cte, ctx);
     // deletes non convex hull primitives
-    deleteNonHullPrims(liv1, cte, ScanDir::CW);
-    deleteNonHullPrims(riv1, cte, ScanDir::CCW);
+    deleteNonHullPrims(liv1, cte, ScanDir::CW, ctx);
+    deleteNonHullPrims(riv1, cte, ScanDir::CCW, ctx);
     // updates convex hull primitives
-    updatePrimitives(cte);
+    updatePrimitives(cte, ctx);
+    // updates number of vertices of the merged convex hull
+    kchnv[liv0] += kchnv[riv0] - ctx.ndv;
+    // releases ids at once to be reused by the next merge
+    if (!ctx.pool.reserved) {
+        releaseIds(ctx.pool);
+    }
 }
 
 /**
@@ -351,37 +1488,30 @@ void ConvexHull::merge2Hulls(int liv0, int riv0) {
  * @param cyclic list of vertices on the silhouette of the right convex hull
  * @param turnning direction
  */
-void ConvexHull::searchCTEdge(int& liv, unordered_map<int, int>& klnxv, int& riv, unordered_map<int, int>& krnxv, bool dir) {
+void ConvexHull::searchCTEdge(ID& liv, vector<ID>& klnxv, ID& riv, vector<ID>& krnxv, bool dir) {
+    STATS_TIMER(SEARCH_CT_EDGE);
     bool changed = false;
     do {
         changed = false;
         // searches the vertex of the common tangent edge on the right convex hull
         while (1) {
-            int nxv = krnxv[riv];
-            int kv[] = { liv, riv, nxv, (int)hva.size() };
-            Vector3d va[] = { Vector3d(hva[kv[0]].x(), hva[kv[0]].y(), 0.0),
-                              Vector3d(hva[kv[1]].x(), hva[kv[1]].y(), 0.0),
-                              Vector3d(hva[kv[2]].x(), hva[kv[2]].y(), 0.0),
-                              Vector3d(hva[kv[2]].x(), hva[kv[2]].y(), SCALE) };
-            if (determ(kv, va) == dir) {
+            ID nxv = krnxv[riv];
+            ID kv[] = { liv, riv, nxv };
+            if (isLeft(kv) == dir) {
                 break;
             }
-            krnxv.erase(riv);
+            krnxv[riv] = NOID;
             riv = nxv;
             changed = true;
         }
         // searches the vertex of the common tangent edge on the left convex hull
         while (1) {
-            int nxv = klnxv[liv];
-            int kv[] = { riv, liv, nxv, (int)hva.size() };
-            Vector3d va[] = { Vector3d(hva[kv[0]].x(), hva[kv[0]].y(), 0.0),
-                              Vector3d(hva[kv[1]].x(), hva[kv[1]].y(), 0.0),
-                              Vector3d(hva[kv[2]].x(), hva[kv[2]].y(), 0.0),
-                              Vector3d(hva[kv[2]].x(), hva[kv[2]].y(), SCALE) };
-            if (determ(kv, va) != dir) {
+            ID nxv = klnxv[liv];
+            ID kv[] = { riv, liv, nxv };
+            if (isLeft(kv) != dir) {
                 break;
             }
-            klnxv.erase(liv);
+            klnxv[liv] = NOID;
             liv = nxv;
             changed = true;
         }
@@ -392,57 +1522,57 @@ void ConvexHull::searchCTEdge(int& liv, unordered_map<int, int>& klnxv, int& riv
  * Wraps 2 convex hulls in cylindrical
  * @param common tangent edge
  */
-void ConvexHull::wrapInCylindrical(int cte0) {
-    int cte1 = cte0;
-    int cte2 = cte0;
-    int liv0 = ksv[cte0];
-    int riv0 = kev[cte0];
-    int liv1 = liv0;
-    int riv1 = riv0;
+void ConvexHull::wrapInCylindrical(ID cte0, MergeContext& ctx) {
+    STATS_TIMER(WRAP_IN_CYLINDRICAL);
+    ID cte1 = cte0;
+    ID cte2 = cte0;
+    ID liv0 = ker[cte0].sv;
+    ID riv0 = ker[cte0].ev;
+    ID liv1 = liv0;
+    ID riv1 = riv0;
     do {
         cte1 = cte2;
         
         // searches the edge of the common tangent face
-        int le = searchEdgeOfCTFace(liv1, riv1, ScanDir::CW);
-        int re = searchEdgeOfCTFace(riv1, liv1, ScanDir::CCW);
-        int liv2 = (liv1 == ksv[le] ? kev[le] : ksv[le]);
-        int riv2 = (riv1 == ksv[re] ? kev[re] : ksv[re]);
+        ID le = searchEdgeOfCTFace(liv1, riv1, ScanDir::CW);
+        ID re = searchEdgeOfCTFace(riv1, liv1, ScanDir::CCW);
+        ID liv2 = (liv1 == ker[le].sv ? ker[le].ev : ker[le].sv);
+        ID riv2 = (riv1 == ker[re].sv ? ker[re].ev : ker[re].sv);
         
         // searches the exterior edge of the common tangent face
-        int kv[] = { riv1, liv1, riv2, liv2 };
-        Vector3d va[] = { hva[kv[0]], hva[kv[1]], hva[kv[2]], hva[kv[3]] };
-        bool lext = determ(kv, va);
+        ID kv[] = { riv1, liv1, riv2, liv2 };
+        bool lext = isFront(kv);
         if (lext) {
-            kep[le] = PrimProperty::BOUNDARY;
+            setProperty(kep, le, PrimProperty::BOUNDARY, ctx);
             liv1 = liv2;
         } else {
-            kep[re] = PrimProperty::BOUNDARY;
+            setProperty(kep, re, PrimProperty::BOUNDARY, ctx);
             riv1 = riv2;
         }
         // entries new common tangent face
-        int f = newFace();
-        kfp[f] = PrimProperty::NEW;
+        ID f = newFace(ctx.pool);
+        setProperty(kfp, f, PrimProperty::NEW, ctx);
         if (liv1 == liv0 && riv1 == riv0) {
             cte2 = cte0;
         } else {
-            cte2 = newEdge();
-            kep[cte2] = PrimProperty::NEW;
-        }
-        klf[cte2] = f;
-        krf[cte1] = f;
-        kfe[f]    = cte2;
-        ksv[cte2] = liv1;
-        kev[cte2] = riv1;
+            cte2 = newEdge(ctx.pool);
+            setProperty(kep, cte2, PrimProperty::NEW, ctx);
+        }
+        ker[cte2].lf = f;
+        ker[cte1].rf = f;
+        kfe[f]       = cte2;
+        ker[cte2].sv = liv1;
+        ker[cte2].ev = riv1;
         if (lext) {
-            kscce[cte2] = le;
-            ksce[cte1]  = le;
-            kece[cte2]  = cte1;
-            kecce[cte1] = cte2;
+            ker[cte2].scce = le;
+            ker[cte1].sce  = le;
+            ker[cte2].ece  = cte1;
+            ker[cte1].ecce = cte2;
         } else {
-            kece[cte2]  = re;
-            kecce[cte1] = re;
-            kscce[cte2] = cte1;
-            ksce[cte1]  = cte2;
+            ker[cte2].ece  = re;
+            ker[cte1].ecce = re;
+            ker[cte2].scce = cte1;
+            ker[cte1].sce  = cte2;
         }
     } while (cte2 != cte0);
 }
@@ -454,34 +1584,57 @@ void ConvexHull::wrapInCylindrical(int cte0) {
  * @param scan direction
  * @return edge of the common tangent face
  */
-int ConvexHull::searchEdgeOfCTFace(int iv0, int eye, ScanDir dir) {
-    int e = kve[iv0];
+ID ConvexHull::searchEdgeOfCTFace(ID iv0, ID eye, ScanDir dir) {
+    // if the edge between 2 adjacent faces is the ridge line for the eye point,
+    // that is the edge of the common tangent face
+    return searchRidgeEdge(iv0, eye, dir);
+}
+
+/**
+ * Searches the ridge edge around the vertex
+ *  - the ridge edge has the front face before and the back face after it
+ *  - faces around the vertex are judged NFAN at once by the batched predicate
+ * @param target vertex
+ * @param eye point, or NOID for the point at infinity in z
+ * @param scan direction
+ * @return ridge edge, or NOID if not found
+ */
+ID ConvexHull::searchRidgeEdge(ID iv0, ID eye, ScanDir dir) {
+    ID kv[NFAN+1][4];
+    GRID va[NFAN+1][4][3];
+    bool kor[NFAN+1];
+    ID ke[NFAN];
+    ID e0 = kve[iv0];
+    ID e = e0;
+    // entries the face before the first edge
+    int nf = 0;
+    getVerticesOfFront(dir == ScanDir::CW ? leftFace(iv0, e) : rightFace(iv0, e), eye, kv[nf], va[nf]);
+    nf++;
     bool or2 = false;
-    if (dir == ScanDir::CW) {
-        or2 = isFront(leftFace(iv0, e), eye);
-    } else {
-        or2 = isFront(rightFace(iv0, e), eye);
-    }
-    while (1) {
-        bool or1 = false;
-        if (dir == ScanDir::CW) {
-            or1 = isFront(rightFace(iv0, e), eye);
-        } else {
-            or1 = isFront(leftFace(iv0, e), eye);
-        }
-        // if the edge between 2 adjacent faces is the ridge line for the eye point,
-        // that is the edge of the common tangent face
-        if (!or1 && or2) {
-            break;
+    do {
+        // entries faces after next edges
+        int ne = 0;
+        do {
+            ke[ne++] = e;
+            getVerticesOfFront(dir == ScanDir::CW ? rightFace(iv0, e) : leftFace(iv0, e), eye, kv[nf], va[nf]);
+            nf++;
+            e = (dir == ScanDir::CW ? nextCWEdge(iv0, e) : nextCCWEdge(iv0, e));
+        } while (ne < NFAN && e != e0);
+        Predicate::orient(nf, kv, va, kor);
+        int k = nf - ne;
+        if (k > 0) {
+            or2 = kor[0];
         }
-        if (dir == ScanDir::CW) {
-            e = nextCWEdge(iv0, e);
-        } else {
-            e = nextCCWEdge(iv0, e);
+        for (int j = 0; j < ne; j++) {
+            bool or1 = kor[k+j];
+            if (!or1 && or2) {
+                return ke[j];
+            }
+            or2 = or1;
         }
-        or2 = or1;
-    }
-    return e;
+        nf = 0;
+    } while (e != e0);
+    return NOID;
 }
 
 /**
@@ -490,21 +1643,22 @@ int ConvexHull::searchEdgeOfCTFace(int iv0, int eye, ScanDir dir) {
  * @param common tangent edge
  * @param scan direction
  */
-void ConvexHull::deleteNonHullPrims(int iv0, int cte0, ScanDir dir) {
-    int e = cte0;
+void ConvexHull::deleteNonHullPrims(ID iv0, ID cte0, ScanDir dir, MergeContext& ctx) {
+    STATS_TIMER(DELETE_NON_HULL_PRIMS);
+    ID e = cte0;
     do {
         e = (dir == ScanDir::CW ? nextCWEdge(iv0, e) : nextCCWEdge(iv0, e));
         
         // deletes all primitives
         if (e == cte0) {
-            deleteAllPrimitives(iv0);
+            deleteAllPrimitives(iv0, ctx);
             break;
         }
-    } while (kep[e] != PrimProperty::BOUNDARY);
+    } while (property(kep, e, ctx) != PrimProperty::BOUNDARY);
     
     // deletes interior primitives
-    if (kep[e] == PrimProperty::BOUNDARY) {
-        deleteIntPrimitives(dir == ScanDir::CW ? leftFace(iv0, e) : rightFace(iv0, e));
+    if (property(kep, e, ctx) == PrimProperty::BOUNDARY) {
+        deleteIntPrimitives(dir == ScanDir::CW ? leftFace(iv0, e) : rightFace(iv0, e), ctx);
     }
 }
 
@@ -512,25 +1666,25 @@ void ConvexHull::deleteNonHullPrims(int iv0, int cte0, ScanDir dir) {
  * Deletes all primitives on the convex hull
  * @param vertex of the common tangent edge
  */
-void ConvexHull::deleteAllPrimitives(int iv0) {
+void ConvexHull::deleteAllPrimitives(ID iv0, MergeContext& ctx) {
     // searches edges and faces to delete
-    vector<int> ketd;
-    vector<int> kftd;
-    int f0 = krf[kve[iv0]];
-    kfp[f0] = PrimProperty::DELETE;
+    vector<ID> ketd;
+    vector<ID> kftd;
+    ID f0 = ker[kve[iv0]].rf;
+    setProperty(kfp, f0, PrimProperty::DELETE, ctx);
     kftd.push_back(f0);
-    for (unsigned int i = 0; i < kftd.size(); i++) {
-        int f1 = kftd[i];
-        int ke[3];
+    for (ID i = 0; i < (ID)kftd.size(); i++) {
+        ID f1 = kftd[i];
+        ID ke[3];
         getEdgesOfTriangle(f1, ke);
         for (int j = 0; j < 3; j++) {
-            int e = ke[j];
-            if (kep[e] == PrimProperty::NOTDEFINED) {
+            ID e = ke[j];
+            if (property(kep, e, ctx) == PrimProperty::NOTDEFINED) {
                 ketd.push_back(e);
-                kep[e] = PrimProperty::DELETE;
-                int f2 = (f1 == krf[e] ? klf[e] : krf[e]);
-                if (kfp[f2] != PrimProperty::DELETE) {
-                    kfp[f2] = PrimProperty::DELETE;
+                setProperty(kep, e, PrimProperty::DELETE, ctx);
+                ID f2 = (f1 == ker[e].rf ? ker[e].lf : ker[e].rf);
+                if (property(kfp, f2, ctx) != PrimProperty::DELETE) {
+                    setProperty(kfp, f2, PrimProperty::DELETE, ctx);
                     kftd.push_back(f2);
                 }
             }
@@ -538,39 +1692,39 @@ void ConvexHull::deleteAllPrimitives(int iv0) {
     }
     
     // searches vertices to delete
-    vector<int> kvtd;
-    int iv = khnv[iv0];
+    vector<ID> kvtd;
+    ID iv = khnv[iv0];
     do {
       kvtd.push_back(iv);
       iv = khnv[iv];
     } while (iv != iv0);
     
     // executes delete of primitives
-    deletePrimitives(kvtd, ketd, kftd);
+    deletePrimitives(kvtd, ketd, kftd, ctx);
 }
 
 /**
  * Deletes interior primitives on the convex hull
  * @param interior face
  */
-void ConvexHull::deleteIntPrimitives(int f0) {
+void ConvexHull::deleteIntPrimitives(ID f0, MergeContext& ctx) {
     // searches edges and faces to delete
-    vector<int> ketd;
-    vector<int> kftd;
-    kfp[f0] = PrimProperty::DELETE;
+    vector<ID> ketd;
+    vector<ID> kftd;
+    setProperty(kfp, f0, PrimProperty::DELETE, ctx);
     kftd.push_back(f0);
-    for (unsigned int i = 0; i < kftd.size(); i++) {
-        int f1 = kftd[i];
-        int ke[3];
+    for (ID i = 0; i < (ID)kftd.size(); i++) {
+        ID f1 = kftd[i];
+        ID ke[3];
         getEdgesOfTriangle(f1, ke);
         for (int j = 0; j < 3; j++) {
-            int e = ke[j];
-            if (kep[e] == PrimProperty::NOTDEFINED) {
+            ID e = ke[j];
+            if (property(kep, e, ctx) == PrimProperty::NOTDEFINED) {
                 ketd.push_back(e);
-                kep[e] = PrimProperty::DELETE;
-                int f2 = (f1 == krf[e] ? klf[e] : krf[e]);
-                if (kfp[f2] != PrimProperty::DELETE) {
-                    kfp[f2] = PrimProperty::DELETE;
+                setProperty(kep, e, PrimProperty::DELETE, ctx);
+                ID f2 = (f1 == ker[e].rf ? ker[e].lf : ker[e].rf);
+                if (property(kfp, f2, ctx) != PrimProperty::DELETE) {
+                    setProperty(kfp, f2, PrimProperty::DELETE, ctx);
                     kftd.push_back(f2);
                 }
             }
@@ -578,15 +1732,15 @@ void ConvexHull::deleteIntPrimitives(int f0) {
     }
     
     // searches vertices to delete
-    vector<int> kvtd;
-    int iv0 = ksv[kfe[f0]];
-    int iv = iv0;
+    vector<ID> kvtd;
+    ID iv0 = ker[kfe[f0]].sv;
+    ID iv = iv0;
     do {
-        int e0 = kve[iv];
-        int e = e0;
+        ID e0 = kve[iv];
+        ID e = e0;
         bool deleted = true;
         do {
-            if (kep[e] == PrimProperty::DELETE) {
+            if (property(kep, e, ctx) == PrimProperty::DELETE) {
                 e = nextCCWEdge(iv, e);
             } else {
                 deleted = false;
@@ -599,7 +1753,7 @@ void ConvexHull::deleteIntPrimitives(int f0) {
     } while (iv != iv0);
     
     // executes delete of primitives
-    deletePrimitives(kvtd, ketd, kftd);
+    deletePrimitives(kvtd, ketd, kftd, ctx);
 }
 
 /**
@@ -608,31 +1762,25 @@ void ConvexHull::deleteIntPrimitives(int f0) {
  * @param edges to delete
  * @param faces to delete
  */
-void ConvexHull::deletePrimitives(vector<int>& kv, vector<int>& ke, vector<int>& kf) {
+void ConvexHull::deletePrimitives(vector<ID>& kv, vector<ID>& ke, vector<ID>& kf, MergeContext& ctx) {
     // deletes faces
-    for_each(kf.begin(), kf.end(), [this](int f) {
-        kfe.erase(f);
+    for_each(kf.begin(), kf.end(), [&](ID f) {
+        deleteFace(f, ctx.pool);
     });
     // deletes edges
-    for_each(ke.begin(), ke.end(), [this](int e) {
-        ksv.erase(e);
-        kev.erase(e);
-        krf.erase(e);
-        klf.erase(e);
-        ksce.erase(e);
-        kscce.erase(e);
-        kece.erase(e);
-        kecce.erase(e);
+    for_each(ke.begin(), ke.end(), [&](ID e) {
+        deleteEdge(e, ctx.pool);
     });
     // deletes vertices
-    for_each(kv.begin(), kv.end(), [this](int iv) {
-        kve.erase(iv);
-        int nv = khnv[iv];
-        int pv = khpv[iv];
+    ctx.ndv += kv.size();
+    for_each(kv.begin(), kv.end(), [this](ID iv) {
+        deleteVertex(iv);
+        ID nv = khnv[iv];
+        ID pv = khpv[iv];
         khnv[pv] = nv;
         khpv[nv] = pv;
-        khnv.erase(iv);
-        khpv.erase(iv);
+        khnv[iv] = NOID;
+        khpv[iv] = NOID;
     });
 }
 
@@ -640,48 +1788,49 @@ void ConvexHull::deletePrimitives(vector<int>& kv, vector<int>& ke, vector<int>&
  * Updates convex hull primitives
  * @param cte0
  */
-void ConvexHull::updatePrimitives(int cte0) {
+void ConvexHull::updatePrimitives(ID cte0, MergeContext& ctx) {
+    STATS_TIMER(UPDATE_PRIMITIVES);
     // updates edges and faces
-    int cte1 = cte0;
-    int cte2 = cte0;
+    ID cte1 = cte0;
+    ID cte2 = cte0;
     do {
         cte1 = cte2;
-        int sv = ksv[cte1];
-        int ev = kev[cte1];
+        ID sv = ker[cte1].sv;
+        ID ev = ker[cte1].ev;
         kve[sv] = cte1;
         kve[ev] = cte1;
-        if (kep[ksce[cte1]] == PrimProperty::NEW) {
-            cte2 = ksce[cte1];
-            int e = kecce[cte1];
-            if (ksv[e] == ev) {
-                ksce[e]  = cte1;
-                kecce[e] = cte2;
-                krf[e]   = krf[cte1];
+        if (property(kep, ker[cte1].sce, ctx) == PrimProperty::NEW) {
+            cte2 = ker[cte1].sce;
+            ID e = ker[cte1].ecce;
+            if (ker[e].sv == ev) {
+                ker[e].sce  = cte1;
+                ker[e].ecce = cte2;
+                ker[e].rf   = ker[cte1].rf;
             } else {
-                kece[e]  = cte1;
-                kscce[e] = cte2;
-                klf[e]   = krf[cte1];
+                ker[e].ece  = cte1;
+                ker[e].scce = cte2;
+                ker[e].lf   = ker[cte1].rf;
             }
         } else {
-            cte2 = kecce[cte1];
-            int e = ksce[cte1];
-            if (ksv[e] == sv) {
-                kscce[e] = cte1;
-                kece[e]  = cte2;
-                klf[e]   = krf[cte1];
+            cte2 = ker[cte1].ecce;
+            ID e = ker[cte1].sce;
+            if (ker[e].sv == sv) {
+                ker[e].scce = cte1;
+                ker[e].ece  = cte2;
+                ker[e].lf   = ker[cte1].rf;
             } else {
-                ksce[e]  = cte2;
-                kecce[e] = cte1;
-                krf[e]   = krf[cte1];
+                ker[e].sce  = cte2;
+                ker[e].ecce = cte1;
+                ker[e].rf   = ker[cte1].rf;
             }
         }
     } while (cte2 != cte0);
 
     // updates vertices
-    int sv = ksv[cte0];
-    int ev = kev[cte0];
-    int nsv = khnv[sv];
-    int nev = khnv[ev];
+    ID sv = ker[cte0].sv;
+    ID ev = ker[cte0].ev;
+    ID nsv = khnv[sv];
+    ID nev = khnv[ev];
     khnv[sv] = nev;
     khnv[ev] = nsv;
     khpv[nsv] = ev;
@@ -693,15 +1842,10 @@ void ConvexHull::updatePrimitives(int cte0) {
  * @param face
  * @return 
  */
-bool ConvexHull::isFront(int f) {
-    int kv[4];
+bool ConvexHull::isFront(ID f) {
+    ID kv[3];
     getVerticesOfTriangle(f, kv);
-    kv[3] = hva.size();
-    Vector3d va[] = { Vector3d(hva[kv[0]].x(), hva[kv[0]].y(), 0.0),
-                      Vector3d(hva[kv[1]].x(), hva[kv[1]].y(), 0.0),
-                      Vector3d(hva[kv[2]].x(), hva[kv[2]].y(), 0.0),
-                      Vector3d(hva[kv[2]].x(), hva[kv[2]].y(), SCALE) };
-    return determ(kv, va);
+    return isLeft(kv);
 }
 
 /**
@@ -709,195 +1853,70 @@ bool ConvexHull::isFront(int f) {
  * @param face
  * @return 
  */
-bool ConvexHull::isFront(int f, int eye) {
-    int kv[4];
+bool ConvexHull::isFront(ID f, ID eye) {
+    ID kv[4];
     getVerticesOfTriangle(f, kv);
     kv[3] = eye;
-    Vector3d va[] = { hva[kv[0]], hva[kv[1]], hva[kv[2]], hva[kv[3]] };
-    return determ(kv, va);
+    return isFront(kv);
 }
 
 /**
- * Is left the direction of 4 vertices
+ * Gets vertices to judge the face front
+ * @param face
+ * @param eye point, or NOID for the point at infinity in z
  * @param id of vertices
  * @param vertices
- * @return left or not
  */
-bool ConvexHull::determ(const int* kv0, const Vector3d* va0) {
-    int* kv = new int[4];
-    Vector3d* va = new Vector3d[4];
-    copy(kv0, kv0 + 4, kv);
-    copy(va0, va0 + 4, va);
-    // sorts vertices by id
-    bool even = sortById(kv, va);
-    // calculates determinant
-    bool posi = determ(va);
-    Memory::releaseArray(&kv);
-    Memory::releaseArray(&va);
-    return !(even ^ posi);
-}
-
-/**
- * Sorts vertices by id
- * @param id of vertices
- * @param vertices
- * @return even or not of swap times
- */
-bool ConvexHull::sortById(int* kv, Vector3d* va) {
-    bool even = true;
-    for (int i = (4 - 2); i >= 0; i--) {
-        for (int j = 0; j <= i; j++) {
-            if (kv[j] > kv[j+1]) {
-                swap(kv[j], kv[j+1]);
-                swap(va[j], va[j+1]);
-                even = !even;
-            }
+void ConvexHull::getVerticesOfFront(ID f, ID eye, ID* kv, GRID (*va)[3]) {
+    getVerticesOfTriangle(f, kv);
+    if (eye == NOID) {
+        // projects the face on the xy plane and lifts the last vertex
+        kv[3] = NOID;
+        for (int i = 0; i < 3; i++) {
+            const GRID* g = coord(kv[i]);
+            va[i][0] = g[0];
+            va[i][1] = g[1];
+            va[i][2] = 0;
         }
-    }
-    return even;
-}
-
-/**
- * Calculates determinant
- * @param vertices
- * @return positive or not of determinant
- */
-bool ConvexHull::determ(const Vector3d* va) {
-    Vector3d dij = va[1] - va[0];
-    Vector3d dik = va[2] - va[0];
-    Vector3d dil = va[3] - va[0];
-    Vector3d djk = va[2] - va[1];
-    Vector3d djl = va[3] - va[1];
-    Vector3d dkl = va[3] - va[2];
-
-    // Calculates in floating point number
-    int is = 0;
-    double df[][3] = {{dij.x(), dij.y(), dij.z()},
-                      {dik.x(), dik.y(), dik.z()},
-                      {dil.x(), dil.y(), dil.z()}};
-    if ((is = determ(df)) != 0)    { return (is > 0 ? true : false); }
-
-    // Calculates in integer and symbol perturbation
-    INT128 d0[][3] = {{ (INT128)dij.x(), (INT128)dij.y(), (INT128)dij.z() },
-                      { (INT128)dik.x(), (INT128)dik.y(), (INT128)dik.z() },
-                      { (INT128)dil.x(), (INT128)dil.y(), (INT128)dil.z() }};
-    if ((is = determ(d0)) != 0)    { return (is > 0 ? true : false); }
-    
-    INT128 d1[][2] = {{ (INT128)djk.y(), (INT128)djk.z() },
-                      { (INT128)djl.y(), (INT128)djl.z() }};
-    if ((is = -determ(d1)) != 0)   { return (is > 0 ? true : false); }
-    
-    INT128 d2[][2] = {{ (INT128)dik.y(), (INT128)dik.z() },
-                      { (INT128)dil.y(), (INT128)dil.z() }};
-    if ((is = determ(d2)) != 0)    { return (is > 0 ? true : false); }
-    
-    INT128 d3[][2] = {{ (INT128)dij.y(), (INT128)dij.z() },
-                      { (INT128)dil.y(), (INT128)dil.z() }};
-    if ((is = -determ(d3)) != 0)   { return (is > 0 ? true : false); }
-    
-    INT128 d4[][2] = {{ (INT128)djk.x(), (INT128)djk.z() },
-                      { (INT128)djl.x(), (INT128)djl.z() }};
-    if ((is = determ(d4)) != 0)    { return (is > 0 ? true : false); }
-
-    if ((is = -(int)dkl.z()) != 0) { return (is > 0 ? true : false); }
-
-    if ((is = (int)djl.z()) != 0)  { return (is > 0 ? true : false); }
-    
-    INT128 d7[][2] = {{ (INT128)dik.x(), (INT128)dik.z() },
-                      { (INT128)dil.x(), (INT128)dil.z() }};
-    if ((is = -determ(d7)) != 0)   { return (is > 0 ? true : false); }
-
-    if ((is = -(int)dil.z()) != 0) { return (is > 0 ? true : false); }
-    
-    INT128 d9[][2] = {{ (INT128)dij.x(), (INT128)dij.z() },
-                      { (INT128)dil.x(), (INT128)dil.z() }};
-    if ((is = determ(d9)) != 0)    { return (is > 0 ? true : false); }
-    
-    INT128 d10[][2] = {{ (INT128)djk.x(), (INT128)djk.y() },
-                       { (INT128)djl.x(), (INT128)djl.y() }};
-    if ((is = -determ(d10)) != 0)  { return (is > 0 ? true : false); }
-
-    if ((is = (int)dkl.y()) != 0)  { return (is > 0 ? true : false); }
-
-    if ((is = -(int)djl.y()) != 0) { return (is > 0 ? true : false); }
-
-    if ((is = -(int)dkl.x()) != 0) { return (is > 0 ? true : false); }
-    
-    return true;
-}
-
-/**
- * Calculates determinant in floating point number
- * @param 3x3 matrix
- * @return positive or not of determinant
- */
-int ConvexHull::determ(const double (*m)[3]) {
-    double h[] = { m[0][0] * m[1][1] * m[2][2],
-                   m[1][0] * m[2][1] * m[0][2],
-                   m[2][0] * m[0][1] * m[1][2],
-                   m[2][0] * m[1][1] * m[0][2],
-                   m[1][0] * m[0][1] * m[2][2],
-                   m[0][0] * m[2][1] * m[1][2] };
-    double hmax = fabs(h[0]);
-    for (int i = 1; i < 6; i++) {
-        double ah = fabs(h[i]);
-        if (hmax < ah) {
-            hmax = ah;
-        }
-    }
-    hmax = (hmax > 1.0 ? hmax : 1.0);
-    double vthr = PREC * hmax;
-    double vdet = h[0] + h[1] + h[2] - h[3] - h[4] - h[5];
-    int is = 0;
-    if (fabs(vdet) < vthr) {
-        is = 0;
-    } else if (vdet > 0.0) {
-        is = 1;
+        va[3][0] = va[2][0];
+        va[3][1] = va[2][1];
+        va[3][2] = (GRID)SCALE;
     } else {
-        is = -1;
+        kv[3] = eye;
+        for (int i = 0; i < 4; i++) {
+            const GRID* g = coord(kv[i]);
+            va[i][0] = g[0];
+            va[i][1] = g[1];
+            va[i][2] = g[2];
+        }
     }
-    return is;
 }
 
 /**
- * Calculates determinant in integer
- * @param 3x3 matrix
- * @return positive or not of determinant
+ * Is the triangle of first 3 vertices front for the last vertex
+ * @param id of vertices
+ * @return front or not
  */
-int ConvexHull::determ(const INT128 (*m)[3]) {
-    INT128 vdet = m[0][0] * m[1][1] * m[2][2] +
-                  m[1][0] * m[2][1] * m[0][2] +
-                  m[2][0] * m[0][1] * m[1][2] -
-                  m[2][0] * m[1][1] * m[0][2] -
-                  m[1][0] * m[0][1] * m[2][2] -
-                  m[0][0] * m[2][1] * m[1][2];
-    int is = 0;
-    if (vdet == 0) {
-        is = 0;
-    } else if (vdet > 0) {
-        is = 1;
-    } else {
-        is = -1;
-    }
-    return is;
+bool ConvexHull::isFront(const ID* kv) {
+    const GRID* va[] = { coord(kv[0]), coord(kv[1]), coord(kv[2]), coord(kv[3]) };
+    return Predicate::orient(kv, va);
 }
 
 /**
- * Calculates determinant in integer
- * @param 2x2 matrix
- * @return positive or not of determinant
+ * Is left the direction of 3 vertices projected on the xy plane
+ *  - the last vertex is lifted to the point at infinity in z
+ * @param id of vertices
+ * @return left or not
  */
-int ConvexHull::determ(const INT128 (*m)[2]) {
-    INT128 vdet = m[0][0] * m[1][1] -
-                  m[1][0] * m[0][1];
-    int is = 0;
-    if (vdet == 0) {
-        is = 0;
-    } else if (vdet > 0) {
-        is = 1;
-    } else {
-        is = -1;
-    }
-    return is;
+bool ConvexHull::isLeft(const ID* kv0) {
+    ID kv[] = { kv0[0], kv0[1], kv0[2], NOID };
+    const GRID* v0 = coord(kv[0]);
+    const GRID* v1 = coord(kv[1]);
+    const GRID* v2 = coord(kv[2]);
+    GRID va0[][3] = { { v0[0], v0[1], 0 },
+                      { v1[0], v1[1], 0 },
+                      { v2[0], v2[1], 0 },
+                      { v2[0], v2[1], (GRID)SCALE } };
+    const GRID* va[] = { va0[0], va0[1], va0[2], va0[3] };
+    return Predicate::orient(kv, va);
 }
-
@@ -12,21 +12,70 @@
 #define	CONVEXHULL_H
 
 #include <vector>
-#include <unordered_map>
-#include <boost/multiprecision/cpp_int.hpp>
+#include <functional>
+#include <random>
 #include "GeoGraph.h"
 #include "Vector3d.h"
+#include "VertexView.h"
+#include "Predicate.h"
+#include "Statistics.h"
 
 using namespace std;
 
-typedef boost::multiprecision::int128_t INT128;
-
 class ConvexHull : public GeoGraph {
 public:
+    // order of merges
+    enum class MergeOrder : int {
+        BREADTH_FIRST,
+        DEPTH_FIRST
+    };
+    // directions of extreme vertices to cull interior vertices
+    enum class Culling : int {
+        NONE,
+        OCTAHEDRON,     // 6 directions of axes
+        POLYTOPE26      // 26 directions of axes, diagonals of faces and diagonals of the cube
+    };
+    // indexed mesh of the convex hull
+    //  - vertices on the convex hull are numbered from 0 in order of ids
+    struct Mesh {
+        vector<ID> kvi;     // index in the input of each vertex
+        vector<ID> kt;      // 3 vertices of each triangle, counter-clockwise seen from outside
+        vector<ID> ke;      // 2 vertices of each edge
+    };
     ConvexHull();
     virtual ~ConvexHull();
     void clear();
-    void construct(const vector<Vector3d>& va);
+    bool construct(const vector<Vector3d>& va);
+    bool construct(const VertexView& vw);
+    bool insert(const Vector3d& v);
+    ID insert(const vector<Vector3d>& va);
+    bool append(const vector<Vector3d>& va);
+    bool append(const VertexView& vw);
+    // index of the vertex in the input
+    // @param vertex
+    // @return index of the vertex in the vertex view,
+    //         or the vertex itself if constructed from the vertex array
+    ID inputIndex(ID iv) const { return (kiv.empty() ? iv : kiv[iv]); };
+    void extract(Mesh& mesh) const;
+    // sets number of threads to merge convex hulls
+    // @param number of threads
+    void setThreads(int nt) { nthr = (nt > 1 ? nt : 1); };
+    // sets order of merges
+    // @param order of merges
+    void setMergeOrder(MergeOrder mo) { order = mo; };
+    // sets directions of extreme vertices to cull interior vertices before the construction
+    // @param directions
+    void setCulling(Culling c) { culling = c; };
+    // sets the function called on the constructing thread before merges
+    // and after each level of merges with number of remaining convex hulls
+    //  - the construction is cancelled if the function returns false
+    // @param function
+    void setProgress(const function<bool(ID)>& f) { progress = f; };
+    // counters and timers of the last construction, and of insertions
+    // and appends after it, counted on threads of this convex hull only
+    // (all zero unless compiled with CONVEXHULL_STATS)
+    // @return counters and timers
+    const Statistics::Record& statistics() const { return stats; };
 private:
     // primitive property
     enum class PrimProperty : int {
@@ -40,37 +89,89 @@ private:
         CW,
         CCW
     };
-    void constInitHulls();
-    void constTetrahedron(int iv);
-    void constDihedron(int iv);
-    int searchSilhouette(int nv, int* kv0);
+    // property stamped by the merge
+    struct PrimStamp {
+        ID epoch;               // epoch of the merge
+        PrimProperty prop;      // property
+    };
+    // context of merges on the thread
+    struct MergeContext {
+        IdPool pool;            // ids of edges and faces for merges
+        ID epoch;               // epoch of the merge
+        ID ndv;                 // number of deleted vertices on the merge
+    };
+    void cullVertices();
+    void sortVertices(ID iv0);
+    void constConvexHull();
+    void constInitHulls(ID iv0);
+    void constTetrahedron(ID iv);
+    void constDihedron(ID iv);
+    ID searchSilhouette(ID nv, ID* kv0);
     void mergeAllHulls();
-    void initProperty();
-    void merge2Hulls(int liv0, int riv0);
-    void searchCTEdge(int& liv, unordered_map<int, int>& klnxv, int& riv, unordered_map<int, int>& krnxv, bool dir);
-    void wrapInCylindrical(int cte0);
-    int searchEdgeOfCTFace(int iv0, int eye, ScanDir dir);
-    void deleteNonHullPrims(int iv0, int cte0, ScanDir dir);
-    void deleteAllPrimitives(int iv0);
-    void deleteIntPrimitives(int f0);
-    void deletePrimitives(vector<int>& kv, vector<int>& ke, vector<int>& kf);
-    void updatePrimitives(int cte0);
-    bool isFront(int f);
-    bool isFront(int f, int eye);
-    bool determ(const int* kv0, const Vector3d* va0);
-    bool sortById(int* kv, Vector3d* va);
-    bool determ(const Vector3d* va);
-    int determ(const double (*m)[3]);
-    int determ(const INT128 (*m)[3]);
-    int determ(const INT128 (*m)[2]);
-    vector<Vector3d> hva;                   // vertex array
-    vector<int> kch;                        // index of convex hulls
-    unordered_map<int, int> khnv;           // cyclic list of vertices on the convex hull
-    unordered_map<int, int> khpv;           // cyclic list of vertices on the convex hull
-    unordered_map<int, int> kcnxv;          // cyclic list of vertices on the silhouette of the convex hull
-    unordered_map<int, int> kccnxv;         // cyclic list of vertices on the silhouette of the convex hull
-    unordered_map<int, PrimProperty> kep;   // property of edges
-    unordered_map<int, PrimProperty> kfp;   // property of faces
+    void mergeHulls(ID& nep);
+    void mergeBreadthFirst(ID& nep);
+    void mergeDepthFirst(ID& nep);
+    void mergeRange(ID ich0, ID ich1, MergeContext& ctx);
+    void initContext(MergeContext& ctx, ID ne, ID nf);
+    void reportProgress();
+    void runTasks(int n, const function<void(int)>& task);
+    // @param list of properties
+    // @param primitive
+    // @param context of the merge
+    // @return property of the primitive on the merge
+    PrimProperty property(const vector<PrimStamp>& kp, ID k, const MergeContext& ctx) const {
+        return (kp[k].epoch == ctx.epoch ? kp[k].prop : PrimProperty::NOTDEFINED);
+    };
+    void setProperty(vector<PrimStamp>& kp, ID k, PrimProperty p, const MergeContext& ctx);
+    void merge2Hulls(ID liv0, ID riv0, MergeContext& ctx);
+    void searchCTEdge(ID& liv, vector<ID>& klnxv, ID& riv, vector<ID>& krnxv, bool dir);
+    void wrapInCylindrical(ID cte0, MergeContext& ctx);
+    ID searchEdgeOfCTFace(ID iv0, ID eye, ScanDir dir);
+    ID searchRidgeEdge(ID iv0, ID eye, ScanDir dir);
+    void deleteNonHullPrims(ID iv0, ID cte0, ScanDir dir, MergeContext& ctx);
+    void deleteAllPrimitives(ID iv0, MergeContext& ctx);
+    void deleteIntPrimitives(ID f0, MergeContext& ctx);
+    void deletePrimitives(vector<ID>& kv, vector<ID>& ke, vector<ID>& kf, MergeContext& ctx);
+    void updatePrimitives(ID cte0, MergeContext& ctx);
+    void appendVertices(ID iv0);
+    ID searchRightMostVertex();
+    void compactVertices();
+    bool insertVertex(ID iv);
+    ID searchVisibleFace(ID iv);
+    void setCenter();
+    bool isFront(ID f);
+    bool isFront(ID f, ID eye);
+    bool isFront(const ID* kv);
+    void getVerticesOfFront(ID f, ID eye, ID* kv, GRID (*va)[3]);
+    bool isLeft(const ID* kv0);
+    // @return number of vertices
+    ID numVertices() const { return hva.size() / 3; };
+    // @param vertex
+    // @return x, y and z of the vertex on the grid
+    const GRID* coord(ID iv) const { return &hva[3*iv]; };
+    vector<GRID> hva;                       // x, y and z of vertices on the grid of PREC
+    vector<ID> kiv;                         // index of the vertex in the input
+    vector<ID> kch;                         // index of convex hulls
+    vector<ID> kchnv;                       // number of vertices of the convex hull of the index
+    vector<ID> khnv;                        // cyclic list of vertices on the convex hull
+    vector<ID> khpv;                        // cyclic list of vertices on the convex hull
+    vector<ID> kcnxv;                       // cyclic list of vertices on the silhouette of the convex hull
+    vector<ID> kccnxv;                      // cyclic list of vertices on the silhouette of the convex hull
+    vector<PrimStamp> kep;                  // property of edges
+    vector<PrimStamp> kfp;                  // property of faces
+    int nthr;                               // number of threads
+    MergeOrder order;                       // order of merges
+    Culling culling;                        // directions of extreme vertices to cull interior vertices
+    Statistics::Record stats;               // counters and timers of the last construction and after it
+    ID nin;                                 // number of vertices in the input
+    MergeContext ictx;                      // context of insertions
+    ID lastf;                               // face created on the last insertion
+    bool hcset;                             // the center is set or not
+    bool silset;                            // the silhouette of the convex hull is valid or not
+    GRID hc[3];                             // center of the convex hull on the grid
+    minstd_rand rng;                        // random numbers of the walk
+    function<bool(ID)> progress;            // function called per level of merges
+    bool cancelled;                         // the construction is cancelled or not
 
 };
 
@@ -5,14 +5,13 @@
  * Created on August 4, 2013, 9:10 PM
  */
 
-#include <algorithm>
-#include <vector>
+#include <cassert>
 #include "GeoGraph.h"
 
 /**
  * Constructor and Destructor
  */
-GeoGraph::GeoGraph() : ep(0), fp(0) {
+GeoGraph::GeoGraph() {
 }
 
 GeoGraph::~GeoGraph() {
@@ -22,39 +21,36 @@ GeoGraph::~GeoGraph() {
  * Clears lists
  */
 void GeoGraph::clear() {
-    ep = 0;
-    fp = 0;
     kfe.clear();
     kve.clear();
-    ksv.clear();
-    kev.clear();
-    klf.clear();
-    krf.clear();
-    ksce.clear();
-    kscce.clear();
-    kece.clear();
-    kecce.clear();
+    ker.clear();
+    kfre.clear();
+    kfrf.clear();
 }
 
 /**
  * @return edges
  */
-vector<int> GeoGraph::edges() {
-    vector<int> ke;
-    for_each(ksv.begin(), ksv.end(), [&](unordered_map<int, int>::value_type k) {
-        ke.push_back(k.first);
-    });
+vector<ID> GeoGraph::edges() const {
+    vector<ID> ke;
+    for (ID e = 0; e < (ID)ker.size(); e++) {
+        if (ker[e].sv != NOID) {
+            ke.push_back(e);
+        }
+    }
     return ke;
 }
 
 /**
  * @return faces
  */
-vector<int> GeoGraph::faces() {
-    vector<int> kf;
-    for_each(kfe.begin(), kfe.end(), [&](unordered_map<int, int>::value_type k) {
-        kf.push_back(k.first);
-    });
+vector<ID> GeoGraph::faces() const {
+    vector<ID> kf;
+    for (ID f = 0; f < (ID)kfe.size(); f++) {
+        if (kfe[f] != NOID) {
+            kf.push_back(f);
+        }
+    }
     return kf;
 }
 
@@ -63,9 +59,9 @@ vector<int> GeoGraph::faces() {
  * @param e
  * @param kv
  */
-void GeoGraph::getVerticesOfEdge(int e, int* kv) {
-    kv[0] = ksv[e];
-    kv[1] = kev[e];
+void GeoGraph::getVerticesOfEdge(ID e, ID* kv) const {
+    kv[0] = ker[e].sv;
+    kv[1] = ker[e].ev;
 }
 
 /**
@@ -73,33 +69,209 @@ void GeoGraph::getVerticesOfEdge(int e, int* kv) {
  * @param face
  * @param vertices
  */
-void GeoGraph::getVerticesOfTriangle(int f, int* kv) {
-    int e = kfe[f];
+void GeoGraph::getVerticesOfTriangle(ID f, ID* kv) const {
+    ID e = kfe[f];
     for (int i = 0; i < 3; i++) {
-        if (f == krf[e]) {
-            kv[i] = ksv[e];
-            e = ksce[e];
+        const EdgeRecord& r = ker[e];
+        if (f == r.rf) {
+            kv[i] = r.sv;
+            e = r.sce;
         } else {
-            kv[i] = kev[e];
-            e = kece[e];
+            kv[i] = r.ev;
+            e = r.ece;
         }
     }
 }
 
+/**
+ * Initializes the list of the vertex to the edge
+ * @param number of vertices
+ */
+void GeoGraph::initVertices(ID nv) {
+    kve.assign(nv, NOID);
+}
+
+/**
+ * Gets the id of the new edge, reusing the id of the deleted edge if any
+ * @return new edge
+ */
+ID GeoGraph::newEdge() {
+    if (kfre.empty()) {
+        ker.push_back({ NOID, NOID, NOID, NOID, NOID, NOID, NOID, NOID });
+        return (ID)ker.size() - 1;
+    }
+    ID e = kfre.back();
+    kfre.pop_back();
+    return e;
+}
+
+/**
+ * Gets the id of the new face, reusing the id of the deleted face if any
+ * @return new face
+ */
+ID GeoGraph::newFace() {
+    if (kfrf.empty()) {
+        kfe.push_back(NOID);
+        return (ID)kfe.size() - 1;
+    }
+    ID f = kfrf.back();
+    kfrf.pop_back();
+    return f;
+}
+
+/**
+ * Reserves ids of edges and faces in the pool
+ *  - takes ids from the free list first, and then grows lists
+ *  - nothing is reserved if both numbers are 0,
+ *    the pool takes ids from the free list on demand
+ * @param pool
+ * @param number of edges
+ * @param number of faces
+ */
+void GeoGraph::reserveIds(IdPool& pool, ID ne, ID nf) {
+    pool.reserved = (ne > 0 || nf > 0);
+    for (ID i = 0; i < ne; i++) {
+        pool.kfre.push_back(newEdge());
+    }
+    for (ID i = 0; i < nf; i++) {
+        pool.kfrf.push_back(newFace());
+    }
+}
+
+/**
+ * Releases ids of edges and faces remaining in the pool to the free list
+ * @param pool
+ */
+void GeoGraph::releaseIds(IdPool& pool) {
+    kfre.insert(kfre.end(), pool.kfre.rbegin(), pool.kfre.rend());
+    kfrf.insert(kfrf.end(), pool.kfrf.rbegin(), pool.kfrf.rend());
+    pool.kfre.clear();
+    pool.kfrf.clear();
+}
+
+/**
+ * Gets the id of the new edge from the pool
+ *  - gets it from the free list if the pool is empty,
+ *    the reserved pool must not be exhausted
+ * @param pool
+ * @return new edge
+ */
+ID GeoGraph::newEdge(IdPool& pool) {
+    if (pool.kfre.empty()) {
+        assert(!pool.reserved);
+        return newEdge();
+    }
+    ID e = pool.kfre.back();
+    pool.kfre.pop_back();
+    return e;
+}
+
+/**
+ * Gets the id of the new face from the pool
+ *  - gets it from the free list if the pool is empty,
+ *    the reserved pool must not be exhausted
+ * @param pool
+ * @return new face
+ */
+ID GeoGraph::newFace(IdPool& pool) {
+    if (pool.kfrf.empty()) {
+        assert(!pool.reserved);
+        return newFace();
+    }
+    ID f = pool.kfrf.back();
+    pool.kfrf.pop_back();
+    return f;
+}
+
+/**
+ * Deletes the edge and returns its id to the pool
+ * @param edge
+ * @param pool
+ */
+void GeoGraph::deleteEdge(ID e, IdPool& pool) {
+    ker[e] = { NOID, NOID, NOID, NOID, NOID, NOID, NOID, NOID };
+    pool.kfre.push_back(e);
+}
+
+/**
+ * Deletes the face and returns its id to the pool
+ * @param face
+ * @param pool
+ */
+void GeoGraph::deleteFace(ID f, IdPool& pool) {
+    kfe[f] = NOID;
+    pool.kfrf.push_back(f);
+}
+
 /**
  * Gets edges of the face as the triangle
  * @param face
  * @param edges
  */
-void GeoGraph::getEdgesOfTriangle(int f, int* ke) {
-    int e = kfe[f];
+void GeoGraph::getEdgesOfTriangle(ID f, ID* ke) {
+    ID e = kfe[f];
     for (int i = 0; i < 3; i++) {
         ke[i] = e;
-        if (f == krf[e]) {
-            e = ksce[e];
+        const EdgeRecord& r = ker[e];
+        if (f == r.rf) {
+            e = r.sce;
         } else {
-            e = kece[e];
+            e = r.ece;
         }
     }
 }
 
+/**
+ * Compacts ids of edges and faces
+ *  - renumbers live edges and faces densely in the order of their ids
+ *    and releases the storage of deleted ones
+ */
+void GeoGraph::compact() {
+    // maps old ids to new ids
+    vector<ID> kem(ker.size(), NOID);
+    vector<ID> kfm(kfe.size(), NOID);
+    ID ne = 0;
+    for (ID e = 0; e < (ID)ker.size(); e++) {
+        if (ker[e].sv != NOID) {
+            kem[e] = ne++;
+        }
+    }
+    ID nf = 0;
+    for (ID f = 0; f < (ID)kfe.size(); f++) {
+        if (kfe[f] != NOID) {
+            kfm[f] = nf++;
+        }
+    }
+    
+    // moves edge records and renumbers their relations
+    for (ID e = 0; e < (ID)ker.size(); e++) {
+        if (kem[e] != NOID) {
+            EdgeRecord r = ker[e];
+            ker[kem[e]] = { r.sv, r.ev, kfm[r.lf], kfm[r.rf],
+                            kem[r.sce], kem[r.scce], kem[r.ece], kem[r.ecce] };
+        }
+    }
+    ker.resize(ne);
+    ker.shrink_to_fit();
+    
+    // moves faces
+    for (ID f = 0; f < (ID)kfe.size(); f++) {
+        if (kfm[f] != NOID) {
+            kfe[kfm[f]] = kem[kfe[f]];
+        }
+    }
+    kfe.resize(nf);
+    kfe.shrink_to_fit();
+    
+    // renumbers edges of vertices
+    for (ID iv = 0; iv < (ID)kve.size(); iv++) {
+        if (kve[iv] != NOID) {
+            kve[iv] = kem[kve[iv]];
+        }
+    }
+    
+    kfre.clear();
+    kfre.shrink_to_fit();
+    kfrf.clear();
+    kfrf.shrink_to_fit();
+}
@@ -10,7 +10,10 @@
 #ifndef GEOGRAPH_H
 #define	GEOGRAPH_H
 
-#include <unordered_map>
+#include <vector>
+#include "Types.h"
+
+#define NOID    (-1)    // id of no primitive
 
 using namespace std;
 
@@ -19,49 +22,82 @@ public:
     GeoGraph();
     virtual ~GeoGraph();
     virtual void clear();
-    vector<int> edges();
-    vector<int> faces();
-    void getVerticesOfEdge(int e, int* kv);
-    void getVerticesOfTriangle(int f, int* kv);
+    vector<ID> edges() const;
+    vector<ID> faces() const;
+    void getVerticesOfEdge(ID e, ID* kv) const;
+    void getVerticesOfTriangle(ID f, ID* kv) const;
+    // @return upper bound of ids of vertices
+    ID vertexBound() const { return kve.size(); };
+    // @return upper bound of ids of faces
+    ID faceBound() const { return kfe.size(); };
+    // @param vertex
+    // @return the vertex is on the graph or not
+    bool isVertex(ID iv) const { return kve[iv] != NOID; };
+    // @param face
+    // @return the face is on the graph or not
+    bool isFace(ID f) const { return kfe[f] != NOID; };
 protected:
-    // @return new edge
-    int newEdge() { return ep++; };
-    // @return new face
-    int newFace() { return fp++; };
+    // edge record
+    //  - relations of the edge are stored side by side,
+    //    so that the navigation around the edge is a single array load
+    struct EdgeRecord {
+        ID sv;      // start vertex
+        ID ev;      // end vertex
+        ID lf;      // left face
+        ID rf;      // right face
+        ID sce;     // next clockwise edge at the start vertex
+        ID scce;    // next counter-clockwise edge at the start vertex
+        ID ece;     // next clockwise edge at the end vertex
+        ID ecce;    // next counter-clockwise edge at the end vertex
+    };
+    // pool of ids of edges and faces
+    //  - ids are reserved in advance, so that the merges
+    //    on disjoint convex hulls allocate ids concurrently
+    //  - the reserved pool never grows lists, which are shared by threads
+    struct IdPool {
+        vector<ID> kfre;    // ids of edges
+        vector<ID> kfrf;    // ids of faces
+        bool reserved;      // ids are reserved in advance or not
+    };
+    void initVertices(ID nv);
+    ID newEdge();
+    ID newFace();
+    void reserveIds(IdPool& pool, ID ne, ID nf);
+    void releaseIds(IdPool& pool);
+    ID newEdge(IdPool& pool);
+    ID newFace(IdPool& pool);
+    void deleteEdge(ID e, IdPool& pool);
+    void deleteFace(ID f, IdPool& pool);
+    // @param vertex
+    void deleteVertex(ID iv) { kve[iv] = NOID; };
     // @param vertex
     // @param edge
     // @return other vertex of edge
-    int otherVertex(int iv, int e) { return (iv == ksv[e] ? kev[e] : ksv[e]); };
+    ID otherVertex(ID iv, ID e) const { const EdgeRecord& r = ker[e]; return (iv == r.sv ? r.ev : r.sv); };
     // @param vertex
     // @param edge
     // @return next clockwise edge
-    int nextCWEdge(int iv, int e) { return (iv == ksv[e] ? ksce[e] : kece[e]); };
+    ID nextCWEdge(ID iv, ID e) const { const EdgeRecord& r = ker[e]; return (iv == r.sv ? r.sce : r.ece); };
     // @param vertex
     // @param edge
     // @return next counter-clockwise edge
-    int nextCCWEdge(int iv, int e) { return (iv == ksv[e] ? kscce[e] : kecce[e]); };
-    void getEdgesOfTriangle(int f, int* ke);
+    ID nextCCWEdge(ID iv, ID e) const { const EdgeRecord& r = ker[e]; return (iv == r.sv ? r.scce : r.ecce); };
+    void getEdgesOfTriangle(ID f, ID* ke);
+    void compact();
     // @param vertex
     // @param edge
     // @return left face of the edge
-    int leftFace(int iv, int e) { return (iv == ksv[e] ? klf[e] : krf[e]); };
+    ID leftFace(ID iv, ID e) const { const EdgeRecord& r = ker[e]; return (iv == r.sv ? r.lf : r.rf); };
     // @param vertex
     // @param edge
     // @return right face of the edge
-    int rightFace(int iv, int e) { return (iv == ksv[e] ? krf[e] : klf[e]); };
-    unordered_map<int, int> kfe;    // list of the face to the edge
-    unordered_map<int, int> kve;    // list of the vertex to the edge
-    unordered_map<int, int> ksv;    // list of the edge to the start vertex
-    unordered_map<int, int> kev;    // list of the edge to the end vertex
-    unordered_map<int, int> klf;    // list of the edge to the left face
-    unordered_map<int, int> krf;    // list of the edge to the right face
-    unordered_map<int, int> ksce;   // list of the edge to the next clockwise edge at the start vertex
-    unordered_map<int, int> kscce;  // list of the edge to the next counter-clockwise edge at the start vertex
-    unordered_map<int, int> kece;   // list of the edge to the next clockwise edge at the end vertex
-    unordered_map<int, int> kecce;  // list of the edge to the next counter-clockwise edge at the end vertex
+    ID rightFace(ID iv, ID e) const { const EdgeRecord& r = ker[e]; return (iv == r.sv ? r.rf : r.lf); };
+    vector<ID> kfe;             // list of the face to the edge
+    vector<ID> kve;             // list of the vertex to the edge
+    vector<EdgeRecord> ker;     // list of the edge records
 private:
-    int ep; // pointer to the id of the edge
-    int fp; // pointer to the id of the face
+    vector<ID> kfre;            // free list of ids of deleted edges
+    vector<ID> kfrf;            // free list of ids of deleted faces
 
 };
 
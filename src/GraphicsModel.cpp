@@ -9,95 +9,251 @@
 #include <random>
 #include <stdlib.h>
 #include <algorithm>
+#include <thread>
+#include <chrono>
 #include "GraphicsModel.h"
 
+#define PREVIEW     (0.1)   // seconds between previews of the construction
+#define NPREVIEW    (1024)  // maximum number of convex hulls of the preview
+
+/**
+ * Counts levels of merges
+ * @param number of convex hulls
+ * @return number of levels to merge them into 1 convex hull
+ */
+static int levels(int n) {
+    int l = 0;
+    while (n > 1) {
+        n = (n + 1) / 2;
+        l++;
+    }
+    return l;
+}
+
 /**
  * Constructor and Destructor
  */
-GraphicsModel::GraphicsModel() {
+GraphicsModel::GraphicsModel() : running(false), cancelled(false), nch0(0), nch(0) {
+    ch.setThreads(thread::hardware_concurrency());
+    clear();
 }
 
 GraphicsModel::~GraphicsModel() {
+    // stops the worker without notifications
+    cancelled = true;
+    if (worker.joinable()) {
+        worker.join();
+    }
 }
 
 /**
  * Clears lists
+ *  - observers keep former snapshots until they are notified
+ *  - waits for the worker, which uses the convex hull
  */
 void GraphicsModel::clear() {
-    va.clear();
-    ea.clear();
-    fa.clear();
+    cancel();
+    wait();
+    ss = make_shared<const Snapshot>(Snapshot{ make_shared<const vector<Vector3d>>(),
+                                               make_shared<const ConvexHull::Mesh>(), 0.0, false });
     ch.clear();
 }
 
 /**
- * Generates vertices
+ * Generates vertices on the worker thread
+ *  - polls the cancellation per vertex, and keeps the current snapshot if cancelled
  * @param number of vertices
  */
 void GraphicsModel::generate(int nv) {
-    clear();
-    srand(time(nullptr));
-    // generates the vertex array in random order
-    // (or loads the vertex array from the file)
-    for (int i = 0; i < nv; i++) {
-        double x, y, z;
-        do {
-            x = (double)rand() / RAND_MAX * 2.0 - 1.0;
-            y = (double)rand() / RAND_MAX * 2.0 - 1.0;
-            z = (double)rand() / RAND_MAX * 2.0 - 1.0;
-        } while ((x * x + y * y + z * z) > 1.0);
-        va.push_back(Vector3d(x, y, z));
-    }
-    /********************************
-     *  must sort vertices in x order
-     ********************************/
-    sort(va.begin(), va.end(), Vector3d::lessX);
-    // notifies observers
-    notifyObservers();
+    run([this, nv](const shared_ptr<const Snapshot>&) -> shared_ptr<const Snapshot> {
+        srand(time(nullptr));
+        // generates the vertex array in random order
+        // (or loads the vertex array from the file)
+        shared_ptr<vector<Vector3d>> va = make_shared<vector<Vector3d>>();
+        va->reserve(nv);
+        for (int i = 0; i < nv && !cancelled; i++) {
+            double x, y, z;
+            do {
+                x = (double)rand() / RAND_MAX * 2.0 - 1.0;
+                y = (double)rand() / RAND_MAX * 2.0 - 1.0;
+                z = (double)rand() / RAND_MAX * 2.0 - 1.0;
+            } while ((x * x + y * y + z * z) > 1.0);
+            va->push_back(Vector3d(x, y, z));
+        }
+        if (cancelled) {
+            return nullptr;
+        }
+        ch.clear();
+        // the convex hull sorts vertices in x order by itself
+        return make_shared<const Snapshot>(Snapshot{ va, make_shared<const ConvexHull::Mesh>(), 0.0, false });
+    });
 }
 
 /**
- * Constructs the 3d convex hull
+ * Constructs the 3d convex hull on the worker thread
+ *  - observers keep the former snapshot until the first preview
+ *    or the end of the construction
+ *  - previews are extracted between levels of merges, when convex hulls
+ *    under merges are valid, at intervals of PREVIEW seconds
+ *    (levels of more than NPREVIEW small convex hulls are skipped,
+ *     their meshes have as many faces as vertices)
+ *  - the mesh is empty if the construction is cancelled
  */
 void GraphicsModel::construct() {
-    // constructs the 3d convex hull
-    ch.construct(va);
-    // updates the edge and the face array
-//    updateEdges();
-    updateFaces();
-    // notifies observers
-    notifyObservers();
+    run([this](const shared_ptr<const Snapshot>& s) -> shared_ptr<const Snapshot> {
+        // reports levels of merges, publishes previews and polls the cancellation
+        chrono::steady_clock::time_point tp = chrono::steady_clock::now();
+        ch.setProgress([&](int n) {
+            if (nch0 == 0) {
+                nch0 = n;
+            }
+            nch = n;
+            if (n > 1 && n <= NPREVIEW && !cancelled && chrono::steady_clock::now() - tp >= chrono::duration<double>(PREVIEW)) {
+                post(make_shared<const Snapshot>(Snapshot{ s->va, extractMesh(), 0.0, true }));
+                // the interval starts after the extraction, so that previews do not hold up merges
+                tp = chrono::steady_clock::now();
+            } else if (wakeup) {
+                wakeup();
+            }
+            return !cancelled;
+        });
+        // constructs the 3d convex hull
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        bool ok = ch.construct(*s->va);
+        chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+        ch.setProgress(nullptr);
+        if (!ok) {
+            return make_shared<const Snapshot>(Snapshot{ s->va, make_shared<const ConvexHull::Mesh>(), 0.0, false });
+        }
+        // the snapshot with the new mesh, vertices are shared
+        return make_shared<const Snapshot>(Snapshot{ s->va, extractMesh(), chrono::duration<double>(t1 - t0).count(), false });
+    });
 }
 
 /**
- * Updates the edge array
+ * Cancels the job of the worker and drops jobs waiting for it
+ *  - returns at once, the generation stops at the next vertex
+ *    and the construction at the next level of merges,
+ *    then deliver() reaps the worker and delivers the result
  */
-void GraphicsModel::updateEdges() {
-    vector<int> ke = ch.edges();
-    ea.clear();
-    for_each(ke.begin(), ke.end(), [&](int k) {
-        int kv[2];
-        ch.getVerticesOfEdge(k, kv);
-        Edge e(k, va[kv[0]], va[kv[1]]);
-        if (e.isValid()) {
-            ea.push_back(e);
-        }
-    });
+void GraphicsModel::cancel() {
+    kjob.clear();
+    cancelled = true;
 }
 
 /**
- * Updates the face array
+ * Delivers the result of the worker on the main thread
+ *  - publishes the snapshot to observers if any
+ *  - reaps the finished worker, and starts the job waiting for it
  */
-void GraphicsModel::updateFaces() {
-    vector<int> kf = ch.faces();
-    fa.clear();
-    for_each(kf.begin(), kf.end(), [&](int k) {
-        int kv[3];
-        ch.getVerticesOfTriangle(k, kv);
-        Face f(k, va[kv[0]], va[kv[1]], va[kv[2]]);
-        if (f.isValid()) {
-            fa.push_back(f);
-        }
+void GraphicsModel::deliver() {
+    // the finished worker has posted the result before the join returns
+    if (!running && worker.joinable()) {
+        worker.join();
+    }
+    shared_ptr<const Snapshot> s;
+    {
+        lock_guard<mutex> lock(mtx);
+        s.swap(pss);
+    }
+    if (s) {
+        ss = s;
+        notifyObservers();
+    }
+    if (!running && !kjob.empty()) {
+        function<shared_ptr<const Snapshot>(const shared_ptr<const Snapshot>&)> job;
+        job.swap(kjob.front());
+        kjob.pop_front();
+        start(job);
+    }
+}
+
+/**
+ * Gets the progress of the job
+ * @return ratio of finished levels of merges, 1 if the worker is not running
+ */
+double GraphicsModel::progress() const {
+    if (!running) {
+        return 1.0;
+    }
+    int l0 = levels(nch0);
+    return (l0 > 0 && nch > 0 ? (double)(l0 - levels(nch)) / l0 : 0.0);
+}
+
+/**
+ * Runs the job on the worker thread
+ *  - jobs run one by one in order of requests, the job requested
+ *    while the worker is running waits until deliver() reaps the worker,
+ *    and starts from the snapshot delivered last,
+ *    so that the construction requested after the generation
+ *    is of the generated vertices
+ *  - returns at once, cancel() stops the running job and drops waiting ones
+ * @param job which makes the snapshot from the current snapshot
+ */
+void GraphicsModel::run(const function<shared_ptr<const Snapshot>(const shared_ptr<const Snapshot>&)>& job) {
+    kjob.push_back(job);
+    if (!running) {
+        deliver();
+    }
+}
+
+/**
+ * Starts the job on the worker thread
+ *  - the former worker must be reaped
+ * @param job which makes the snapshot from the current snapshot
+ */
+void GraphicsModel::start(const function<shared_ptr<const Snapshot>(const shared_ptr<const Snapshot>&)>& job) {
+    cancelled = false;
+    nch0 = 0;
+    nch = 0;
+    running = true;
+    shared_ptr<const Snapshot> s0 = ss;
+    worker = thread([this, job, s0]() {
+        shared_ptr<const Snapshot> s = job(s0);
+        running = false;
+        post(s);
     });
 }
 
+/**
+ * Posts the snapshot to the main thread
+ *  - replaces the snapshot not delivered yet, so that only the newest one is drawn
+ * @param snapshot
+ */
+void GraphicsModel::post(const shared_ptr<const Snapshot>& s) {
+    {
+        lock_guard<mutex> lock(mtx);
+        pss = s;
+    }
+    if (wakeup) {
+        wakeup();
+    }
+}
+
+/**
+ * Waits for the worker and the job waiting for it, and delivers the result
+ *  - blocks the main thread, only for the convex hull used out of jobs
+ */
+void GraphicsModel::wait() {
+    while (worker.joinable()) {
+        worker.join();
+        deliver();
+    }
+}
+
+/**
+ * Extracts the indexed mesh
+ *  - indices of triangles and edges refer to the vertex array directly
+ * @return indexed mesh
+ */
+shared_ptr<const ConvexHull::Mesh> GraphicsModel::extractMesh() const {
+    shared_ptr<ConvexHull::Mesh> hm = make_shared<ConvexHull::Mesh>();
+    ch.extract(*hm);
+    for (ID& k : hm->kt) {
+        k = hm->kvi[k];
+    }
+    for (ID& k : hm->ke) {
+        k = hm->kvi[k];
+    }
+    return hm;
+}
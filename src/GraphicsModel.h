@@ -2,6 +2,12 @@
  * Graphics model class
  *  - inherits Subject class
  *  - implements vertices, edges, faces and 3d convex hull
+ *  - publishes an immutable snapshot to observers, which keep it without copies
+ *  - generates vertices and constructs the 3d convex hull on the worker thread
+ *    one job after another in order of requests,
+ *    and publishes the result on the main thread by deliver()
+ *  - publishes previews of convex hulls under merges at intervals,
+ *    only the newest one is delivered
  * File:   GraphicsModel.h
  * Author: munehiro
  *
@@ -12,31 +18,63 @@
 #define	GRAPHICSMODEL_H
 
 #include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
 #include "Subject.h"
 #include "Vector3d.h"
-#include "Edge.h"
-#include "Face.h"
 #include "ConvexHull.h"
 
 using namespace std;
 
 class GraphicsModel : public Subject {
 public:
+    // immutable snapshot of the model
+    //  - vertices and the mesh are shared by snapshots while they are not changed
+    struct Snapshot {
+        shared_ptr<const vector<Vector3d>> va;  // vertex array
+        shared_ptr<const ConvexHull::Mesh> hm;  // indexed mesh of the 3d convex hull, indices refer to the vertex array
+        double ct;                              // seconds of the construction
+        bool partial;                           // the mesh is of convex hulls under merges or not
+    };
     GraphicsModel();
     virtual ~GraphicsModel();
     void clear();
     void generate(int nv);
     void construct();
-    const vector<Vector3d> vertices() const { return va; };
-    const vector<Edge>& edges() const { return ea; };
-    const vector<Face>& faces() const { return fa; };
+    void cancel();
+    void deliver();
+    double progress() const;
+    // @return the worker is running or not
+    bool isRunning() const { return running; };
+    // sets the function to wake up the main thread
+    //  - called on the worker thread per level of merges, per preview and at the end,
+    //    then the main thread calls deliver()
+    // @param function
+    void setWakeup(const function<void()>& f) { wakeup = f; };
+    // current snapshot, observers may keep it
+    // @return snapshot
+    shared_ptr<const Snapshot> snapshot() const { return ss; };
 private:
-    void updateEdges();
-    void updateFaces();
-    vector<Vector3d> va;    // vertex array
-    vector<Edge> ea;        // edge array
-    vector<Face> fa;        // face array
-    ConvexHull ch;          // 3d convex hull
+    void run(const function<shared_ptr<const Snapshot>(const shared_ptr<const Snapshot>&)>& job);
+    void start(const function<shared_ptr<const Snapshot>(const shared_ptr<const Snapshot>&)>& job);
+    void wait();
+    void post(const shared_ptr<const Snapshot>& s);
+    shared_ptr<const ConvexHull::Mesh> extractMesh() const;
+    shared_ptr<const Snapshot> ss;  // current snapshot
+    ConvexHull ch;                  // 3d convex hull
+    thread worker;                  // worker thread
+    mutex mtx;                      // lock of the result
+    shared_ptr<const Snapshot> pss; // result of the worker not delivered yet
+    deque<function<shared_ptr<const Snapshot>(const shared_ptr<const Snapshot>&)>> kjob;   // jobs waiting for the worker in order of requests
+    function<void()> wakeup;        // function to wake up the main thread
+    atomic<bool> running;           // the worker is running or not
+    atomic<bool> cancelled;         // the job of the worker is cancelled or not
+    atomic<int> nch0;               // number of convex hulls before merges
+    atomic<int> nch;                // number of remaining convex hulls
 
 };
 
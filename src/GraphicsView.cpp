@@ -5,6 +5,9 @@
  * Created on August 3, 2013, 7:21 PM
  */
 
+#define GL_GLEXT_PROTOTYPES     // buffer objects of OpenGL 1.5
+
+#include <cmath>
 #include <algorithm>
 #include <GL/freeglut.h>
 #include "GraphicsView.h"
@@ -18,11 +21,61 @@ extern "C" {
 #define NEARCLIP    ( 5.0)  // near clip position
 #define FARCLIP     (40.0)  // far clip position
 #define EYEPOINT    (-7.0)  // eye point
+#define NBUDGET     (262144)    // vertices drawn per frame while the view rotates
+#define NIDLE       (200)   // milliseconds without motions to draw all vertices
+#define NSTRAT      (16)    // cells of the stratification along each axis
+
+/**
+ * Orders vertices for the level of detail
+ *  - divides the bounding box into NSTRAT^3 cells, and orders vertices by
+ *    their rank in the cell divided by the number of vertices in the cell,
+ *    so that each prefix of the order samples every cell in proportion to it
+ * @param vertex array
+ * @param order of vertices
+ */
+static void stratify(const vector<Vector3d>& va, vector<int>& ko) {
+    int nv = va.size();
+    ko.resize(nv);
+    if (nv == 0) {
+        return;
+    }
+    // bounding box
+    double lo[] = { va[0].x(), va[0].y(), va[0].z() };
+    double hi[] = { va[0].x(), va[0].y(), va[0].z() };
+    for (int i = 1; i < nv; i++) {
+        for (int k = 0; k < 3; k++) {
+            lo[k] = min(lo[k], va[i].get()[k]);
+            hi[k] = max(hi[k], va[i].get()[k]);
+        }
+    }
+    // cell and rank in the cell of each vertex
+    vector<int> kc(nv);
+    vector<int> kn(NSTRAT * NSTRAT * NSTRAT, 0);
+    vector<pair<double, int>> kr(nv);
+    for (int i = 0; i < nv; i++) {
+        int c = 0;
+        for (int k = 0; k < 3; k++) {
+            double w = hi[k] - lo[k];
+            int j = (w > 0.0 ? (int)((va[i].get()[k] - lo[k]) / w * NSTRAT) : 0);
+            c = c * NSTRAT + min(j, NSTRAT - 1);
+        }
+        kc[i] = c;
+        kr[i].first = kn[c]++;
+    }
+    for (int i = 0; i < nv; i++) {
+        kr[i].first = (kr[i].first + 0.5) / kn[kc[i]];
+        kr[i].second = i;
+    }
+    sort(kr.begin(), kr.end());
+    for (int i = 0; i < nv; i++) {
+        ko[i] = kr[i].second;
+    }
+}
 
 /**
  * Constructor and Destructor
  */
-GraphicsView::GraphicsView() : mx(0), my(0) {
+GraphicsView::GraphicsView() : mx(0), my(0), vdirty(true), mdirty(true), vb(0), eb(0), tb(0), hb(0), nvb(0), neb(0), ntb(0), nhb(0), full(true) {
     currQ[0] = 0.0f; currQ[1] = 0.0f; currQ[2] = 0.0f; currQ[3] = 1.0f;
     Glib::RefPtr<Gdk::GL::Config> cfg(Gdk::GL::Config::create(Gdk::GL::MODE_RGB   |
                                                               Gdk::GL::MODE_DEPTH |
@@ -40,6 +93,7 @@ GraphicsView::GraphicsView() : mx(0), my(0) {
 }
 
 GraphicsView::~GraphicsView() {
+    idle.disconnect();
 }
 
 /**
@@ -49,9 +103,13 @@ GraphicsView::~GraphicsView() {
 void GraphicsView::update(const Subject* sbj) {
     GraphicsModel* model = (GraphicsModel*)sbj;
     if (model) {
-        va = model->vertices(); // gets vertices
-        ea = model->edges();    // gets vertices of the edges
-        fa = model->faces();    // gets vertices and normal vector of the faces
+        // keeps the snapshot of vertices and the mesh,
+        // and uploads changed ones on the next expose event
+        // (previews of the construction share vertices)
+        shared_ptr<const GraphicsModel::Snapshot> s = model->snapshot();
+        vdirty |= (!ss || s->va != ss->va);
+        mdirty |= (!ss || s->hm != ss->hm);
+        ss = s;
         get_window()->invalidate_rect(get_allocation(), false);
     }
 }
@@ -91,9 +149,34 @@ void GraphicsView::on_realize() {
     glEnable(GL_LIGHTING);
     glEnable(GL_DEPTH_TEST);
     glShadeModel(GL_SMOOTH);
+    // buffer objects of vertices, edges and faces
+    glGenBuffers(1, &vb);
+    glGenBuffers(1, &eb);
+    glGenBuffers(1, &tb);
+    glGenBuffers(1, &hb);
+    vdirty = true;
+    mdirty = true;
     drw->gl_end();
 }
 
+/**
+ * On unrealize
+ *  - deletes buffer objects while the context is alive
+ */
+void GraphicsView::on_unrealize() {
+    Glib::RefPtr<Gdk::GL::Drawable> drw(get_gl_drawable());
+    if (drw && drw->gl_begin(get_gl_context())) {
+        glDeleteBuffers(1, &vb);
+        glDeleteBuffers(1, &eb);
+        glDeleteBuffers(1, &tb);
+        glDeleteBuffers(1, &hb);
+        vb = eb = tb = hb = 0;
+        nvb = neb = ntb = nhb = 0;
+        drw->gl_end();
+    }
+    Gtk::DrawingArea::on_unrealize();
+}
+
 /**
  * On configure event
  * @param event
@@ -137,6 +220,9 @@ bool GraphicsView::on_expose_event(GdkEventExpose* evt) {
     if (!drw->gl_begin(get_gl_context())) {
         return false;
     }
+    if (vdirty || mdirty) {
+        upload();
+    }
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glLoadIdentity();
     // converts the current quaternion to the transformation matrix
@@ -188,6 +274,10 @@ bool GraphicsView::on_motion_notify_event(GdkEventMotion* evt) {
                          (2.f * cx - w) / w,
                          (h - 2.f * cy) / h);
         add_quats(lastQ, currQ, currQ);
+        // draws the level of detail until the view stops
+        full = false;
+        idle.disconnect();
+        idle = Glib::signal_timeout().connect(sigc::mem_fun(*this, &GraphicsView::refine), NIDLE);
         get_window()->invalidate_rect(get_allocation(), false);
     }
     mx = cx;
@@ -195,6 +285,89 @@ bool GraphicsView::on_motion_notify_event(GdkEventMotion* evt) {
     return false;
 }
 
+/**
+ * Draws all vertices when the view stops
+ * @return false to stop the timer
+ */
+bool GraphicsView::refine() {
+    full = true;
+    get_window()->invalidate_rect(get_allocation(), false);
+    return false;
+}
+
+/**
+ * Uploads vertices, edges and faces to buffer objects
+ *  - vertices are in the stratified order, and are shared by points, edges and
+ *    vertices of the convex hull, indices of them refer to the order
+ *  - each vertex of triangles has the normal of the triangle for the flat shading
+ */
+void GraphicsView::upload() {
+    bool vd = vdirty;
+    bool md = mdirty;
+    vdirty = false;
+    mdirty = false;
+    if (!ss) {
+        return;
+    }
+    const vector<Vector3d>& va = *ss->va;
+    const ConvexHull::Mesh& hm = *ss->hm;
+    // vertices
+    if (vd) {
+        vector<int> ko;
+        stratify(va, ko);
+        kp.resize(va.size());
+        vector<GLfloat> vf(3 * va.size());
+        for (unsigned int i = 0; i < va.size(); i++) {
+            kp[ko[i]] = i;
+            vf[3*i]   = va[ko[i]].x();
+            vf[3*i+1] = va[ko[i]].y();
+            vf[3*i+2] = va[ko[i]].z();
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, vb);
+        glBufferData(GL_ARRAY_BUFFER, vf.size() * sizeof(GLfloat), vf.data(), GL_STATIC_DRAW);
+        nvb = va.size();
+    }
+    // edges and faces
+    if (md) {
+        // indices of edges and vertices of the convex hull in the stratified order
+        vector<GLuint> ke(hm.ke.size());
+        for (unsigned int i = 0; i < hm.ke.size(); i++) {
+            ke[i] = kp[hm.ke[i]];
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eb);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, ke.size() * sizeof(GLuint), ke.data(), GL_STATIC_DRAW);
+        neb = ke.size();
+        vector<GLuint> kh(hm.kvi.size());
+        for (unsigned int i = 0; i < hm.kvi.size(); i++) {
+            kh[i] = kp[hm.kvi[i]];
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, hb);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, kh.size() * sizeof(GLuint), kh.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        nhb = kh.size();
+        // normals and vertices of triangles
+        vector<GLfloat> tf(6 * hm.kt.size());
+        for (unsigned int i = 0; i < hm.kt.size(); i += 3) {
+            const Vector3d& v0 = va[hm.kt[i]];
+            Vector3d n = (va[hm.kt[i+1]] - v0).cross(va[hm.kt[i+2]] - v0);
+            double l = sqrt(n.dot(n));
+            if (l > 0.0) {
+                n /= l;
+            }
+            for (int k = 0; k < 3; k++) {
+                const Vector3d& v = va[hm.kt[i+k]];
+                GLfloat* p = &tf[6 * (i + k)];
+                p[0] = n.x(); p[1] = n.y(); p[2] = n.z();
+                p[3] = v.x(); p[4] = v.y(); p[5] = v.z();
+            }
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, tb);
+        glBufferData(GL_ARRAY_BUFFER, tf.size() * sizeof(GLfloat), tf.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        ntb = hm.kt.size();
+    }
+}
+
 /**
  * Draws x, y, z axis
  * @param transformation matrix
@@ -233,25 +406,26 @@ void GraphicsView::drawAxis(const float m[4][4]) {
 
 /**
  * Draws vertices
+ *  - draws the prefix of NBUDGET vertices in the stratified order
+ *    and vertices of the convex hull while the view rotates
  */
 void GraphicsView::drawVertices() {
     glPushMatrix();
     glDisable(GL_LIGHTING);
     glColor3d(1.0, 0.4, 0.0);
     glPointSize(3.0f);
-    int i = 0;
-    for_each(va.begin(), va.end(), [&i](Vector3d v) {
-        glBegin(GL_POINTS);
-        glVertex3dv(v.get());
-        glEnd();
-/**
-        ostringstream str;
-        str << i;
-        glRasterPos3dv((v + 0.01).get());
-        glutBitmapString(GLUT_BITMAP_HELVETICA_12, (unsigned char*)str.str().c_str());
-        i++;
-**/
-    });
+    glBindBuffer(GL_ARRAY_BUFFER, vb);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, nullptr);
+    GLsizei n = (full ? nvb : min(nvb, (GLsizei)NBUDGET));
+    glDrawArrays(GL_POINTS, 0, n);
+    if (n < nvb) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, hb);
+        glDrawElements(GL_POINTS, nhb, GL_UNSIGNED_INT, nullptr);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
     glEnable(GL_LIGHTING);
     glPopMatrix();
 }
@@ -264,21 +438,14 @@ void GraphicsView::drawEdges() {
     glDisable(GL_LIGHTING);
     glColor3d(0.9, 1.0, 0.0);
     glLineWidth(1.0f);
-    for_each(ea.begin(), ea.end(), [](Edge e) {
-        glBegin(GL_LINES);
-        glVertex3dv(e.vertex(0).get());
-        glVertex3dv(e.vertex(1).get());
-        glEnd();
-/**
-        ostringstream str;
-        str << e.id();
-        Vector3d v1(e.vertex(0));
-        Vector3d v2(e.vertex(1));
-        Vector3d cv = (v1 + v2) / 2.0;
-        glRasterPos3dv(cv.get());
-        glutBitmapString(GLUT_BITMAP_HELVETICA_12, (unsigned char*)str.str().c_str());
-**/
-    });
+    glBindBuffer(GL_ARRAY_BUFFER, vb);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eb);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, nullptr);
+    glDrawElements(GL_LINES, neb, GL_UNSIGNED_INT, nullptr);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
     glEnable(GL_LIGHTING);
     glPopMatrix();
 }
@@ -295,18 +462,15 @@ void GraphicsView::drawFaces() {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glDepthMask(GL_FALSE);
 
-    for_each(fa.begin(), fa.end(), [](Face f) {
-        glBegin(GL_TRIANGLES);
-        glNormal3dv(f.normal().get());
-        glVertex3dv(f.vertex(0).get());
-        glVertex3dv(f.vertex(1).get());
-        glVertex3dv(f.vertex(2).get());
-        glEnd();
-    });
+    glBindBuffer(GL_ARRAY_BUFFER, tb);
+    glInterleavedArrays(GL_N3F_V3F, 0, nullptr);
+    glDrawArrays(GL_TRIANGLES, 0, ntb);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     glDepthMask(GL_TRUE);
     glDisable(GL_BLEND);
 
     glPopMatrix();
 }
-
@@ -2,6 +2,10 @@
  * Graphics view class
  *  - inherits Gtk::GL::DrawingArea and Observer class
  *  - draws vertices, edges and faces by OpenGL
+ *  - uploads vertices, edges and faces to buffer objects when the model changes,
+ *    and draws them by a few draw calls on each expose event
+ *  - draws at most NBUDGET vertices in the stratified order and vertices of
+ *    the convex hull while the view rotates, and all vertices when it stops
  * File:   GraphicsView.h
  * Author: munehiro
  *
@@ -11,15 +15,12 @@
 #ifndef GRAPHICSVIEW_H
 #define	GRAPHICSVIEW_H
 
-#include "Triangle.h"
-
-
 #include <vector>
+#include <memory>
 #include <gtkglextmm-1.2/gtkglmm.h>
 #include "Observer.h"
 #include "Vector3d.h"
-#include "Edge.h"
-#include "Face.h"
+#include "GraphicsModel.h"
 
 using namespace std;
 
@@ -30,20 +31,34 @@ public:
     void update(const Subject* sbj);
 protected:
     void on_realize();
+    void on_unrealize();
     bool on_configure_event(GdkEventConfigure* evt);
     bool on_expose_event(GdkEventExpose* evt);
     bool on_button_press_event(GdkEventButton* evt);
     bool on_motion_notify_event(GdkEventMotion* evt);
 private:
+    void upload();
+    bool refine();
     void drawAxis(const float m[4][4]);
     void drawVertices();
     void drawEdges();
     void drawFaces();
     int mx, my;             // mouse point
     float currQ[4];         // current quaternion
-    vector<Vector3d> va;    // vertex array
-    vector<Edge> ea;        // edge array
-    vector<Face> fa;        // face array
+    shared_ptr<const GraphicsModel::Snapshot> ss;   // snapshot of the model
+    bool vdirty;            // buffer object of vertices is older than the model or not
+    bool mdirty;            // buffer objects of edges and faces are older than the model or not
+    GLuint vb;              // buffer object of vertices
+    GLuint eb;              // buffer object of indices of edges
+    GLuint tb;              // buffer object of normals and vertices of triangles
+    GLuint hb;              // buffer object of indices of vertices of the convex hull
+    GLsizei nvb;            // number of vertices in the buffer object
+    GLsizei neb;            // number of indices of edges in the buffer object
+    GLsizei ntb;            // number of vertices of triangles in the buffer object
+    GLsizei nhb;            // number of indices of vertices of the convex hull in the buffer object
+    vector<int> kp;         // position in the buffer object of each vertex
+    bool full;              // draws all vertices or not
+    sigc::connection idle;  // timer to draw all vertices when the view stops
 
 };
 
@@ -14,18 +14,26 @@ MainWindow::MainWindow(BaseObjectType* obj, const Glib::RefPtr<Gtk::Builder> bld
 : Gtk::Window(obj) {
     view = shared_ptr<GraphicsView>(new GraphicsView);
     model.addObserver(view);
+    // the worker of the model wakes up the main loop
+    dispatcher.connect(sigc::mem_fun(*this, &MainWindow::deliver));
+    model.setWakeup([this]() {
+        dispatcher.emit();
+    });
     
     // defines UI parts
     Gtk::Viewport* viewport;
     Gtk::Button*   genButton;
     Gtk::Button*   conButton;
+    Gtk::Button*   canButton;
     
     bld->get_widget("viewport",   viewport);
     bld->get_widget("spin_button", spinButton);
     bld->get_widget("gen_button", genButton);
     bld->get_widget("con_button", conButton);
+    bld->get_widget("can_button", canButton);
+    bld->get_widget("progress_bar", progressBar);
     
-    spinButton->set_range(7.0, 30000.0);
+    spinButton->set_range(7.0, 10000000.0);
     spinButton->set_increments(1.0, 10.0);
     spinButton->set_value(7.0);
     
@@ -33,11 +41,15 @@ MainWindow::MainWindow(BaseObjectType* obj, const Glib::RefPtr<Gtk::Builder> bld
     
     genButton->signal_clicked().connect(sigc::mem_fun(*this , &MainWindow::generate));
     conButton->signal_clicked().connect(sigc::mem_fun(*this , &MainWindow::construct));
+    canButton->signal_clicked().connect(sigc::mem_fun(*this , &MainWindow::cancel));
     
     show_all_children();
 }
 
 MainWindow::~MainWindow() {
+    // cancels the worker, the model is destroyed before the dispatcher
+    // and joins the worker
+    model.cancel();
     model.deleteObserver(view);
 }
 
@@ -53,5 +65,23 @@ void MainWindow::generate() {
  */
 void MainWindow::construct() {
     model.construct();
+    progressBar->set_fraction(0.0);
+}
+
+/**
+ * Cancels the construction
+ */
+void MainWindow::cancel() {
+    model.cancel();
+    progressBar->set_fraction(0.0);
+}
+
+/**
+ * Delivers the progress or the result of the worker
+ *  - the view keeps drawing the former convex hull until the result
+ */
+void MainWindow::deliver() {
+    model.deliver();
+    progressBar->set_fraction(model.isRunning() ? model.progress() : 0.0);
 }
 
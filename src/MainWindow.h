@@ -1,6 +1,8 @@
 /* 
  * Main window class
  *  - instantiates the model and the view object
+ *  - wakes up the main loop by the dispatcher when the worker of the model
+ *    makes progress or ends
  * File:   MainWindow.h
  * Author: munehiro
  *
@@ -24,7 +26,11 @@ public:
 private:
     void generate();
     void construct();
+    void cancel();
+    void deliver();
     Gtk::SpinButton* spinButton;    // spin button
+    Gtk::ProgressBar* progressBar;  // progress bar of the construction
+    Glib::Dispatcher dispatcher;    // dispatcher from the worker to the main loop
     GraphicsModel model;            // model of this application
     shared_ptr<GraphicsView> view;  // view of this application
 
@@ -0,0 +1,218 @@
+/*
+ * File:   MeshWriter.cpp
+ * Author: munehiro
+ *
+ * Created on October 17, 2026, 9:10 AM
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include "MeshWriter.h"
+
+#define NBUF    (1 << 20)       // bytes of the buffer
+#define NSTLH   (80)            // bytes of the STL header
+#define NSTLF   (50)            // bytes of the STL face
+
+/**
+ * Constructor and Destructor
+ */
+MeshWriter::MeshWriter() : fd(-1), failed(false), buf(NBUF), nbuf(0), nv(0), nf(0) {
+}
+
+MeshWriter::~MeshWriter() {
+}
+
+/**
+ * Writes the convex hull to the file
+ * @param file name
+ * @param format of the file
+ * @param convex hull
+ * @param vertices which the convex hull is constructed from
+ * @return succeeded or not
+ */
+bool MeshWriter::write(const string& fn, Format fmt, const ConvexHull& ch, const VertexView& vw) {
+    fd = ::open(fn.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    failed = false;
+    nbuf = 0;
+    // numbers vertices in order of ids, and counts faces
+    kvn.assign(ch.vertexBound(), NOID);
+    nv = 0;
+    for (ID iv = 0; iv < ch.vertexBound(); iv++) {
+        if (ch.isVertex(iv)) {
+            kvn[iv] = nv++;
+        }
+    }
+    nf = 0;
+    for (ID f = 0; f < ch.faceBound(); f++) {
+        nf += ch.isFace(f);
+    }
+    // indices of the PLY and the number of faces of the STL are 32 bit
+    if (fmt != Format::OBJ && (nv > INT32_MAX || nf > INT32_MAX)) {
+        failed = true;
+    } else if (fmt == Format::PLY) {
+        writePLY(ch, vw);
+    } else if (fmt == Format::STL) {
+        writeSTL(ch, vw);
+    } else {
+        writeOBJ(ch, vw);
+    }
+    flush();
+    failed |= (::close(fd) != 0);
+    fd = -1;
+    kvn = vector<ID>();
+    return !failed;
+}
+
+/**
+ * Gets numbers in the file of 3 vertices of the triangle
+ * @param convex hull
+ * @param face
+ * @param numbers of vertices, counter-clockwise seen from outside
+ */
+void MeshWriter::getTriangle(const ConvexHull& ch, ID f, ID* kn) const {
+    ID kv[3];
+    ch.getVerticesOfTriangle(f, kv);
+    for (int i = 0; i < 3; i++) {
+        kn[i] = kvn[kv[i]];
+    }
+}
+
+/**
+ * Writes the binary little endian PLY
+ * @param convex hull
+ * @param vertices
+ */
+void MeshWriter::writePLY(const ConvexHull& ch, const VertexView& vw) {
+    char hdr[256];
+    int n = snprintf(hdr, sizeof(hdr),
+                     "ply\n"
+                     "format binary_little_endian 1.0\n"
+                     "element vertex %d\n"
+                     "property double x\n"
+                     "property double y\n"
+                     "property double z\n"
+                     "element face %d\n"
+                     "property list uchar int vertex_indices\n"
+                     "end_header\n", (int)nv, (int)nf);
+    put(hdr, n);
+    for (ID iv = 0; iv < ch.vertexBound(); iv++) {
+        if (ch.isVertex(iv)) {
+            double v[3];
+            vw.get(ch.inputIndex(iv), v);
+            put(v, sizeof(v));
+        }
+    }
+    for (ID f = 0; f < ch.faceBound(); f++) {
+        if (ch.isFace(f)) {
+            ID kn[3];
+            getTriangle(ch, f, kn);
+            char rec[1 + 3 * sizeof(int32_t)];
+            int32_t kn32[] = { (int32_t)kn[0], (int32_t)kn[1], (int32_t)kn[2] };
+            rec[0] = 3;
+            memcpy(rec + 1, kn32, sizeof(kn32));
+            put(rec, sizeof(rec));
+        }
+    }
+}
+
+/**
+ * Writes the binary STL
+ *  - STL has no shared vertices, each face has its normal and 3 vertices
+ * @param convex hull
+ * @param vertices
+ */
+void MeshWriter::writeSTL(const ConvexHull& ch, const VertexView& vw) {
+    char hdr[NSTLH + sizeof(uint32_t)] = "ch3d convex hull";
+    uint32_t n = nf;
+    memcpy(hdr + NSTLH, &n, sizeof(n));
+    put(hdr, sizeof(hdr));
+    for (ID f = 0; f < ch.faceBound(); f++) {
+        if (!ch.isFace(f)) {
+            continue;
+        }
+        ID kv[3];
+        ch.getVerticesOfTriangle(f, kv);
+        double v[3][3];
+        for (int i = 0; i < 3; i++) {
+            vw.get(ch.inputIndex(kv[i]), v[i]);
+        }
+        // normal of the face
+        double a[] = { v[1][0] - v[0][0], v[1][1] - v[0][1], v[1][2] - v[0][2] };
+        double b[] = { v[2][0] - v[0][0], v[2][1] - v[0][1], v[2][2] - v[0][2] };
+        double nm[] = { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+        double l = sqrt(nm[0] * nm[0] + nm[1] * nm[1] + nm[2] * nm[2]);
+        float rec[12];
+        for (int k = 0; k < 3; k++) {
+            rec[k] = (l > 0.0 ? nm[k] / l : 0.0);
+            rec[3+k] = v[0][k];
+            rec[6+k] = v[1][k];
+            rec[9+k] = v[2][k];
+        }
+        char frec[NSTLF] = { 0 };
+        memcpy(frec, rec, sizeof(rec));
+        put(frec, sizeof(frec));
+    }
+}
+
+/**
+ * Writes the Wavefront OBJ
+ * @param convex hull
+ * @param vertices
+ */
+void MeshWriter::writeOBJ(const ConvexHull& ch, const VertexView& vw) {
+    char line[128];
+    for (ID iv = 0; iv < ch.vertexBound(); iv++) {
+        if (ch.isVertex(iv)) {
+            double v[3];
+            vw.get(ch.inputIndex(iv), v);
+            int n = snprintf(line, sizeof(line), "v %.17g %.17g %.17g\n", v[0], v[1], v[2]);
+            put(line, n);
+        }
+    }
+    for (ID f = 0; f < ch.faceBound(); f++) {
+        if (ch.isFace(f)) {
+            ID kn[3];
+            getTriangle(ch, f, kn);
+            // numbers of OBJ start from 1
+            int n = snprintf(line, sizeof(line), "f %lld %lld %lld\n", (long long)kn[0] + 1, (long long)kn[1] + 1, (long long)kn[2] + 1);
+            put(line, n);
+        }
+    }
+}
+
+/**
+ * Puts bytes to the buffer
+ * @param bytes
+ * @param number of bytes
+ */
+void MeshWriter::put(const void* p, size_t n) {
+    if (nbuf + n > buf.size()) {
+        flush();
+    }
+    memcpy(&buf[nbuf], p, n);
+    nbuf += n;
+}
+
+/**
+ * Writes bytes in the buffer to the file
+ */
+void MeshWriter::flush() {
+    size_t k = 0;
+    while (k < nbuf && !failed) {
+        ssize_t n = ::write(fd, &buf[k], nbuf - k);
+        if (n < 0 && errno != EINTR) {
+            failed = true;
+        } else if (n > 0) {
+            k += n;
+        }
+    }
+    nbuf = 0;
+}
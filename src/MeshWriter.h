@@ -0,0 +1,54 @@
+/*
+ * Mesh writer class
+ *  - writes the convex hull to the binary PLY, the binary STL or the OBJ
+ *  - streams vertices and faces from passes over the topology
+ *    of the convex hull through the buffer, without the indexed mesh,
+ *    vertices are shared and numbered compactly
+ * File:   MeshWriter.h
+ * Author: munehiro
+ *
+ * Created on October 17, 2026, 9:10 AM
+ */
+
+#ifndef MESHWRITER_H
+#define	MESHWRITER_H
+
+#include <string>
+#include <vector>
+#include "ConvexHull.h"
+#include "VertexView.h"
+
+using namespace std;
+
+class MeshWriter {
+public:
+    // format of the file
+    enum class Format : int {
+        PLY,        // binary little endian PLY
+        STL,        // binary STL
+        OBJ         // Wavefront OBJ
+    };
+    MeshWriter();
+    virtual ~MeshWriter();
+    bool write(const string& fn, Format fmt, const ConvexHull& ch, const VertexView& vw);
+private:
+    MeshWriter(const MeshWriter& orig);
+    MeshWriter& operator =(const MeshWriter& rhs);
+    void writePLY(const ConvexHull& ch, const VertexView& vw);
+    void writeSTL(const ConvexHull& ch, const VertexView& vw);
+    void writeOBJ(const ConvexHull& ch, const VertexView& vw);
+    void getTriangle(const ConvexHull& ch, ID f, ID* kn) const;
+    void put(const void* p, size_t n);
+    void flush();
+    int fd;                 // file descriptor
+    bool failed;            // writes failed or not
+    vector<char> buf;       // buffer of the output
+    size_t nbuf;            // bytes in the buffer
+    vector<ID> kvn;         // number in the file of each vertex of the convex hull
+    ID nv;                  // number of vertices in the file
+    ID nf;                  // number of faces in the file
+
+};
+
+#endif	/* MESHWRITER_H */
+
@@ -0,0 +1,327 @@
+/*
+ * File:   Predicate.cpp
+ * Author: munehiro
+ *
+ * Created on October 17, 2026, 9:10 AM
+ */
+
+#include <cfloat>
+#include <cmath>
+#include <utility>
+#include <algorithm>
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include "Predicate.h"
+#include "Statistics.h"
+
+#define EPS     (DBL_EPSILON * 0.5)                 // unit roundoff
+#define ERRBND  ((7.0 + 56.0 * EPS) * EPS)          // relative error bound of the determinant
+
+using namespace std;
+
+/**
+ * Constructor and Destructor
+ */
+Predicate::Predicate() {
+}
+
+Predicate::~Predicate() {
+}
+
+/**
+ * Is left the direction of 4 vertices
+ *  - the negative id of the last vertex denotes the point at infinity in z
+ *    above the third vertex, the vertex is lifted on the grid
+ *    but perturbed as the infinity
+ * @param id of vertices
+ * @param vertices
+ * @return left or not
+ */
+bool Predicate::orient(const ID* kv0, const GRID* const* va0) {
+    if (kv0[3] < 0) {
+        // the last vertex is at infinity in z
+        int is = filter(va0);
+        STATS_COUNT(ORIENT);
+        if (is != 0) {
+            STATS_COUNT(FILTER);
+            return (is > 0);
+        }
+        return orientXY(kv0, va0);
+    }
+    ID kv[] = { kv0[0], kv0[1], kv0[2], kv0[3] };
+    const GRID* va[] = { va0[0], va0[1], va0[2], va0[3] };
+    // sorts vertices by id
+    bool even = sortById(4, kv, va);
+    // calculates in floating point number
+    int is = filter(va);
+    STATS_COUNT(ORIENT);
+    if (is != 0) {
+        STATS_COUNT(FILTER);
+    }
+    // calculates in integer and symbol perturbation
+    bool posi = (is != 0 ? is > 0 : exact(va));
+    return !(even ^ posi);
+}
+
+/**
+ * Is left the direction of 4 vertices for each of the quadruples
+ *  - the floating point stage runs for NLANE quadruples at once,
+ *    only undecided quadruples fall back to the integer stage
+ * @param number of quadruples
+ * @param id of vertices
+ * @param vertices
+ * @param left or not
+ */
+void Predicate::orient(int n, const ID (*kv0)[4], const GRID (*va0)[4][3], bool* kor) {
+    for (int i = 0; i < n; i += NLANE) {
+        ID kv[NLANE][4];
+        const GRID* va[NLANE][4];
+        bool even[NLANE];
+        alignas(32) double c[4][3][NLANE];
+        // sorts vertices by id and loads them lane by lane
+        // (the tail lanes repeat the last quadruple,
+        //  integers on the grid are exact in floating point number)
+        for (int l = 0; l < NLANE; l++) {
+            int k = min(i + l, n - 1);
+            for (int j = 0; j < 4; j++) {
+                kv[l][j] = kv0[k][j];
+                va[l][j] = va0[k][j];
+            }
+            even[l] = (kv[l][3] < 0 || sortById(4, kv[l], va[l]));
+            for (int j = 0; j < 4; j++) {
+                c[j][0][l] = (double)va[l][j][0];
+                c[j][1][l] = (double)va[l][j][1];
+                c[j][2][l] = (double)va[l][j][2];
+            }
+        }
+        // calculates in floating point number
+        int is[NLANE];
+        filter(c, is);
+        // calculates in integer and symbol perturbation
+        for (int l = 0; l < NLANE && i + l < n; l++) {
+            STATS_COUNT(ORIENT);
+            if (is[l] != 0) {
+                STATS_COUNT(FILTER);
+            }
+            bool posi = (is[l] != 0 ? is[l] > 0 :
+                         kv[l][3] < 0 ? orientXY(kv[l], va[l]) : exact(va[l]));
+            kor[i + l] = !(even[l] ^ posi);
+        }
+    }
+}
+
+/**
+ * Is left the direction of 3 vertices projected on the xy plane
+ *  - the symbol perturbation is the same as the one of 4 vertices,
+ *    the point at infinity in z is not perturbed
+ * @param id of vertices
+ * @param vertices
+ * @return left or not
+ */
+bool Predicate::orientXY(const ID* kv0, const GRID* const* va0) {
+    ID kv[] = { kv0[0], kv0[1], kv0[2] };
+    const GRID* va[] = { va0[0], va0[1], va0[2] };
+    bool even = sortById(3, kv, va);
+    return !(even ^ exactXY(va));
+}
+
+/**
+ * Sorts vertices by id in descending order
+ *  - sorting network of 3 or 4 elements
+ *  - the vertex of the larger id is perturbed more in x,
+ *    so that vertices of the same x are ordered by id as they are sorted
+ * @param number of vertices
+ * @param id of vertices
+ * @param vertices
+ * @return even or not of swap times
+ */
+bool Predicate::sortById(int n, ID* kv, const GRID** va) {
+    static const int net3[][2] = { { 0, 1 }, { 1, 2 }, { 0, 1 } };
+    static const int net4[][2] = { { 0, 1 }, { 2, 3 }, { 0, 2 }, { 1, 3 }, { 1, 2 } };
+    const int (*net)[2] = (n == 3 ? net3 : net4);
+    int nn = (n == 3 ? 3 : 5);
+    bool even = true;
+    for (int i = 0; i < nn; i++) {
+        int j = net[i][0];
+        int k = net[i][1];
+        if (kv[j] < kv[k]) {
+            swap(kv[j], kv[k]);
+            swap(va[j], va[k]);
+            even = !even;
+        }
+    }
+    return even;
+}
+
+/**
+ * Calculates determinant in floating point number
+ *  - the sign is decided only if the determinant exceeds
+ *    the bound of the rounding error
+ *  - differences of integers are exact in floating point number
+ * @param vertices
+ * @return 1, -1 or 0 if not decided
+ */
+int Predicate::filter(const GRID* const* va) {
+    double adx = (double)va[1][0] - va[0][0], ady = (double)va[1][1] - va[0][1], adz = (double)va[1][2] - va[0][2];
+    double bdx = (double)va[2][0] - va[0][0], bdy = (double)va[2][1] - va[0][1], bdz = (double)va[2][2] - va[0][2];
+    double cdx = (double)va[3][0] - va[0][0], cdy = (double)va[3][1] - va[0][1], cdz = (double)va[3][2] - va[0][2];
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+    double vdet = adz * (bdxcdy - cdxbdy) +
+                  bdz * (cdxady - adxcdy) +
+                  cdz * (adxbdy - bdxady);
+    double perm = (fabs(bdxcdy) + fabs(cdxbdy)) * fabs(adz) +
+                  (fabs(cdxady) + fabs(adxcdy)) * fabs(bdz) +
+                  (fabs(adxbdy) + fabs(bdxady)) * fabs(cdz);
+    double vthr = ERRBND * perm;
+    if (vdet > vthr) {
+        return 1;
+    } else if (-vdet > vthr) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Calculates determinants of NLANE quadruples in floating point number
+ *  - evaluates the same expression as filter() lane by lane
+ * @param coordinates of vertices by the vertex, the axis and the lane
+ * @param 1, -1 or 0 if not decided
+ */
+void Predicate::filter(const double (*c)[3][NLANE], int* is) {
+#if defined(__AVX__)
+    const __m256d mabs = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d x0 = _mm256_load_pd(c[0][0]), y0 = _mm256_load_pd(c[0][1]), z0 = _mm256_load_pd(c[0][2]);
+    __m256d adx = _mm256_sub_pd(_mm256_load_pd(c[1][0]), x0);
+    __m256d ady = _mm256_sub_pd(_mm256_load_pd(c[1][1]), y0);
+    __m256d adz = _mm256_sub_pd(_mm256_load_pd(c[1][2]), z0);
+    __m256d bdx = _mm256_sub_pd(_mm256_load_pd(c[2][0]), x0);
+    __m256d bdy = _mm256_sub_pd(_mm256_load_pd(c[2][1]), y0);
+    __m256d bdz = _mm256_sub_pd(_mm256_load_pd(c[2][2]), z0);
+    __m256d cdx = _mm256_sub_pd(_mm256_load_pd(c[3][0]), x0);
+    __m256d cdy = _mm256_sub_pd(_mm256_load_pd(c[3][1]), y0);
+    __m256d cdz = _mm256_sub_pd(_mm256_load_pd(c[3][2]), z0);
+
+    __m256d bdxcdy = _mm256_mul_pd(bdx, cdy), cdxbdy = _mm256_mul_pd(cdx, bdy);
+    __m256d cdxady = _mm256_mul_pd(cdx, ady), adxcdy = _mm256_mul_pd(adx, cdy);
+    __m256d adxbdy = _mm256_mul_pd(adx, bdy), bdxady = _mm256_mul_pd(bdx, ady);
+
+    __m256d vdet = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(adz, _mm256_sub_pd(bdxcdy, cdxbdy)),
+                                               _mm256_mul_pd(bdz, _mm256_sub_pd(cdxady, adxcdy))),
+                                 _mm256_mul_pd(cdz, _mm256_sub_pd(adxbdy, bdxady)));
+    __m256d perm = _mm256_add_pd(_mm256_add_pd(
+        _mm256_mul_pd(_mm256_add_pd(_mm256_and_pd(bdxcdy, mabs), _mm256_and_pd(cdxbdy, mabs)), _mm256_and_pd(adz, mabs)),
+        _mm256_mul_pd(_mm256_add_pd(_mm256_and_pd(cdxady, mabs), _mm256_and_pd(adxcdy, mabs)), _mm256_and_pd(bdz, mabs))),
+        _mm256_mul_pd(_mm256_add_pd(_mm256_and_pd(adxbdy, mabs), _mm256_and_pd(bdxady, mabs)), _mm256_and_pd(cdz, mabs)));
+    __m256d vthr = _mm256_mul_pd(_mm256_set1_pd(ERRBND), perm);
+    int posi = _mm256_movemask_pd(_mm256_cmp_pd(vdet, vthr, _CMP_GT_OQ));
+    int nega = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_sub_pd(_mm256_setzero_pd(), vdet), vthr, _CMP_GT_OQ));
+#elif defined(__SSE2__)
+    const __m128d mabs = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+    __m128d x0 = _mm_load_pd(c[0][0]), y0 = _mm_load_pd(c[0][1]), z0 = _mm_load_pd(c[0][2]);
+    __m128d adx = _mm_sub_pd(_mm_load_pd(c[1][0]), x0);
+    __m128d ady = _mm_sub_pd(_mm_load_pd(c[1][1]), y0);
+    __m128d adz = _mm_sub_pd(_mm_load_pd(c[1][2]), z0);
+    __m128d bdx = _mm_sub_pd(_mm_load_pd(c[2][0]), x0);
+    __m128d bdy = _mm_sub_pd(_mm_load_pd(c[2][1]), y0);
+    __m128d bdz = _mm_sub_pd(_mm_load_pd(c[2][2]), z0);
+    __m128d cdx = _mm_sub_pd(_mm_load_pd(c[3][0]), x0);
+    __m128d cdy = _mm_sub_pd(_mm_load_pd(c[3][1]), y0);
+    __m128d cdz = _mm_sub_pd(_mm_load_pd(c[3][2]), z0);
+
+    __m128d bdxcdy = _mm_mul_pd(bdx, cdy), cdxbdy = _mm_mul_pd(cdx, bdy);
+    __m128d cdxady = _mm_mul_pd(cdx, ady), adxcdy = _mm_mul_pd(adx, cdy);
+    __m128d adxbdy = _mm_mul_pd(adx, bdy), bdxady = _mm_mul_pd(bdx, ady);
+
+    __m128d vdet = _mm_add_pd(_mm_add_pd(_mm_mul_pd(adz, _mm_sub_pd(bdxcdy, cdxbdy)),
+                                         _mm_mul_pd(bdz, _mm_sub_pd(cdxady, adxcdy))),
+                              _mm_mul_pd(cdz, _mm_sub_pd(adxbdy, bdxady)));
+    __m128d perm = _mm_add_pd(_mm_add_pd(
+        _mm_mul_pd(_mm_add_pd(_mm_and_pd(bdxcdy, mabs), _mm_and_pd(cdxbdy, mabs)), _mm_and_pd(adz, mabs)),
+        _mm_mul_pd(_mm_add_pd(_mm_and_pd(cdxady, mabs), _mm_and_pd(adxcdy, mabs)), _mm_and_pd(bdz, mabs))),
+        _mm_mul_pd(_mm_add_pd(_mm_and_pd(adxbdy, mabs), _mm_and_pd(bdxady, mabs)), _mm_and_pd(cdz, mabs)));
+    __m128d vthr = _mm_mul_pd(_mm_set1_pd(ERRBND), perm);
+    int posi = _mm_movemask_pd(_mm_cmpgt_pd(vdet, vthr));
+    int nega = _mm_movemask_pd(_mm_cmpgt_pd(_mm_sub_pd(_mm_setzero_pd(), vdet), vthr));
+#else
+    GRID v[4][3];
+    const GRID* va[4];
+    for (int j = 0; j < 4; j++) {
+        v[j][0] = (GRID)c[j][0][0]; v[j][1] = (GRID)c[j][1][0]; v[j][2] = (GRID)c[j][2][0];
+        va[j] = v[j];
+    }
+    int is0 = filter(va);
+    int posi = (is0 > 0);
+    int nega = (is0 < 0);
+#endif
+    for (int l = 0; l < NLANE; l++) {
+        is[l] = ((posi >> l) & 1) - ((nega >> l) & 1);
+    }
+}
+
+/**
+ * Calculates determinant in integer and symbol perturbation
+ *  - differences of coordinates on the grid are exact in INT128
+ * @param vertices
+ * @return positive or not of determinant
+ */
+bool Predicate::exact(const GRID* const* va) {
+    INT128 dij[] = { (INT128)va[1][0] - va[0][0], (INT128)va[1][1] - va[0][1], (INT128)va[1][2] - va[0][2] };
+    INT128 dik[] = { (INT128)va[2][0] - va[0][0], (INT128)va[2][1] - va[0][1], (INT128)va[2][2] - va[0][2] };
+    INT128 dil[] = { (INT128)va[3][0] - va[0][0], (INT128)va[3][1] - va[0][1], (INT128)va[3][2] - va[0][2] };
+    INT128 djk[] = { (INT128)va[2][0] - va[1][0], (INT128)va[2][1] - va[1][1], (INT128)va[2][2] - va[1][2] };
+    INT128 djl[] = { (INT128)va[3][0] - va[1][0], (INT128)va[3][1] - va[1][1], (INT128)va[3][2] - va[1][2] };
+    INT128 dkl[] = { (INT128)va[3][0] - va[2][0], (INT128)va[3][1] - va[2][1], (INT128)va[3][2] - va[2][2] };
+
+    STATS_COUNT(EXACT);
+    int is = 0;
+    if ((is = sign(dij[0] * (dik[1] * dil[2] - dil[1] * dik[2]) +
+                   dik[0] * (dil[1] * dij[2] - dij[1] * dil[2]) +
+                   dil[0] * (dij[1] * dik[2] - dik[1] * dij[2]))) != 0) { STATS_SOS(0); return (is > 0); }
+
+    // symbol perturbation in the order of the id of vertices
+    if ((is = -determ(djk[1], djk[2], djl[1], djl[2])) != 0)    { STATS_SOS(1); return (is > 0); }
+    if ((is =  determ(dik[1], dik[2], dil[1], dil[2])) != 0)    { STATS_SOS(2); return (is > 0); }
+    if ((is = -determ(dij[1], dij[2], dil[1], dil[2])) != 0)    { STATS_SOS(3); return (is > 0); }
+    if ((is =  determ(djk[0], djk[2], djl[0], djl[2])) != 0)    { STATS_SOS(4); return (is > 0); }
+    if ((is = -sign(dkl[2])) != 0)                              { STATS_SOS(5); return (is > 0); }
+    if ((is =  sign(djl[2])) != 0)                              { STATS_SOS(6); return (is > 0); }
+    if ((is = -determ(dik[0], dik[2], dil[0], dil[2])) != 0)    { STATS_SOS(7); return (is > 0); }
+    if ((is = -sign(dil[2])) != 0)                              { STATS_SOS(8); return (is > 0); }
+    if ((is =  determ(dij[0], dij[2], dil[0], dil[2])) != 0)    { STATS_SOS(9); return (is > 0); }
+    if ((is = -determ(djk[0], djk[1], djl[0], djl[1])) != 0)    { STATS_SOS(10); return (is > 0); }
+    if ((is =  sign(dkl[1])) != 0)                              { STATS_SOS(11); return (is > 0); }
+    if ((is = -sign(djl[1])) != 0)                              { STATS_SOS(12); return (is > 0); }
+    if ((is = -sign(dkl[0])) != 0)                              { STATS_SOS(13); return (is > 0); }
+
+    STATS_SOS(14);
+    return true;
+}
+
+/**
+ * Calculates determinant of 3 vertices projected on the xy plane
+ * in integer and symbol perturbation
+ * @param vertices
+ * @return positive or not of determinant
+ */
+bool Predicate::exactXY(const GRID* const* va) {
+    INT128 dij[] = { (INT128)va[1][0] - va[0][0], (INT128)va[1][1] - va[0][1] };
+    INT128 dik[] = { (INT128)va[2][0] - va[0][0], (INT128)va[2][1] - va[0][1] };
+    INT128 djk[] = { (INT128)va[2][0] - va[1][0], (INT128)va[2][1] - va[1][1] };
+
+    STATS_COUNT(EXACT);
+    int is = 0;
+    if ((is = determ(dij[0], dij[1], dik[0], dik[1])) != 0)     { STATS_SOS(0); return (is > 0); }
+
+    // symbol perturbation in the order of the id of vertices
+    if ((is = -sign(djk[1])) != 0)                              { STATS_SOS(1); return (is > 0); }
+    if ((is =  sign(dik[1])) != 0)                              { STATS_SOS(2); return (is > 0); }
+    if ((is =  sign(djk[0])) != 0)                              { STATS_SOS(4); return (is > 0); }
+
+    STATS_SOS(5);
+    return false;
+}
@@ -0,0 +1,52 @@
+/*
+ * Predicate class
+ *  - implements the orientation predicate of 4 vertices,
+ *    and of 3 vertices projected on the xy plane
+ *  - coordinates are integers on the grid, less than 2^40 in magnitude
+ *  - decides by the floating point filter and falls back
+ *    to the integer and the symbol perturbation
+ * File:   Predicate.h
+ * Author: munehiro
+ *
+ * Created on October 17, 2026, 9:10 AM
+ */
+
+#ifndef PREDICATE_H
+#define	PREDICATE_H
+
+#if defined(__AVX__)
+#define NLANE   (4)     // number of lanes of the batched filter
+#elif defined(__SSE2__)
+#define NLANE   (2)     // number of lanes of the batched filter
+#else
+#define NLANE   (1)     // number of lanes of the batched filter
+#endif
+
+#include "Types.h"
+
+class Predicate {
+public:
+    static bool orient(const ID* kv0, const GRID* const* va0);
+    static void orient(int n, const ID (*kv0)[4], const GRID (*va0)[4][3], bool* kor);
+    virtual ~Predicate();
+private:
+    Predicate();
+    static bool orientXY(const ID* kv0, const GRID* const* va0);
+    static bool sortById(int n, ID* kv, const GRID** va);
+    static int filter(const GRID* const* va);
+    static void filter(const double (*c)[3][NLANE], int* is);
+    static bool exact(const GRID* const* va);
+    static bool exactXY(const GRID* const* va);
+    // sign of the value
+    // @param value
+    // @return 1, 0 or -1
+    static int sign(INT128 v) { return (v > 0) - (v < 0); };
+    // sign of the determinant of 2x2 matrix
+    // @param 2x2 matrix
+    // @return 1, 0 or -1
+    static int determ(INT128 a, INT128 b, INT128 c, INT128 d) { return sign(a * d - c * b); };
+
+};
+
+#endif	/* PREDICATE_H */
+
@@ -0,0 +1,148 @@
+/*
+ * File:   Statistics.cpp
+ * Author: munehiro
+ *
+ * Created on October 17, 2026, 9:10 AM
+ */
+
+#include <cstdio>
+#include "Statistics.h"
+
+using namespace std;
+
+// names of counters and phases in JSON
+static const char* const COUNTERS[] = { "orient", "filter", "exact" };
+static const char* const PHASES[] = {
+    "cullVertices", "sortVertices", "constInitHulls", "searchSilhouette",
+    "searchCTEdge", "wrapInCylindrical", "deleteNonHullPrims", "updatePrimitives"
+};
+
+/**
+ * Constructor and Destructor
+ */
+Statistics::Statistics() {
+}
+
+Statistics::~Statistics() {
+}
+
+/**
+ * Constructor of counters and timers
+ */
+Statistics::Record::Record() {
+    clear();
+}
+
+/**
+ * Clears counters and timers
+ */
+void Statistics::Record::clear() {
+    for (int i = 0; i < (int)Counter::NCOUNTER; i++) {
+        kc[i] = 0;
+    }
+    for (int i = 0; i < NSOS; i++) {
+        ksos[i] = 0;
+    }
+    for (int i = 0; i < (int)Phase::NPHASE; i++) {
+        kpn[i] = 0;
+        kpt[i] = 0;
+    }
+}
+
+/**
+ * Adds counters and timers
+ * @param counters and timers
+ * @return this
+ */
+Statistics::Record& Statistics::Record::operator +=(const Record& rhs) {
+    for (int i = 0; i < (int)Counter::NCOUNTER; i++) {
+        kc[i] += rhs.kc[i];
+    }
+    for (int i = 0; i < NSOS; i++) {
+        ksos[i] += rhs.ksos[i];
+    }
+    for (int i = 0; i < (int)Phase::NPHASE; i++) {
+        kpn[i] += rhs.kpn[i];
+        kpt[i] += rhs.kpt[i];
+    }
+    return *this;
+}
+
+/**
+ * Stops the timer and adds the time to the phase
+ */
+Statistics::Timer::~Timer() {
+    Record& r = local();
+    r.kpn[(int)phase]++;
+    r.kpt[(int)phase] += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Gets counters on the thread
+ * @return counters and timers
+ */
+Statistics::Record& Statistics::local() {
+    static thread_local Record rec;
+    return rec;
+}
+
+/**
+ * Is compiled in the statistics
+ * @return enabled or not
+ */
+bool Statistics::enabled() {
+#ifdef CONVEXHULL_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Resets counters of the calling thread
+ *  - drops counters of the work before, which belong to no one
+ */
+void Statistics::reset() {
+    local().clear();
+}
+
+/**
+ * Collects counters of the calling thread and resets them
+ *  - the owner of the work adds them to its own counters,
+ *    so that counters of concurrent works are not mixed
+ * @return counters and timers
+ */
+Statistics::Record Statistics::collect() {
+    Record r = local();
+    local().clear();
+    return r;
+}
+
+/**
+ * Formats counters and timers in JSON
+ * @param counters and timers
+ * @return JSON
+ */
+string Statistics::toJSON(const Record& r) {
+    string s;
+    char buf[128];
+    s += (enabled() ? "{\"enabled\":true" : "{\"enabled\":false");
+    s += ",\"predicates\":{";
+    for (int i = 0; i < (int)Counter::NCOUNTER; i++) {
+        snprintf(buf, sizeof(buf), "%s\"%s\":%lld", (i > 0 ? "," : ""), COUNTERS[i], r.kc[i]);
+        s += buf;
+    }
+    s += ",\"sos_depth\":[";
+    for (int i = 0; i < NSOS; i++) {
+        snprintf(buf, sizeof(buf), "%s%lld", (i > 0 ? "," : ""), r.ksos[i]);
+        s += buf;
+    }
+    s += "]},\"phases\":{";
+    for (int i = 0; i < (int)Phase::NPHASE; i++) {
+        snprintf(buf, sizeof(buf), "%s\"%s\":{\"calls\":%lld,\"seconds\":%.6f}",
+                 (i > 0 ? "," : ""), PHASES[i], r.kpn[i], r.kpt[i] * 1.0e-9);
+        s += buf;
+    }
+    s += "}}";
+    return s;
+}
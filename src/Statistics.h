@@ -0,0 +1,94 @@
+/*
+ * Statistics class
+ *  - counts outcomes of predicates and times phases of the construction
+ *  - compiled in only if CONVEXHULL_STATS is defined,
+ *    otherwise STATS_* macros are empty
+ *  - counts on each thread, the owner of the work collects counters
+ *    of its threads into its own, there is no total of the process
+ * File:   Statistics.h
+ * Author: munehiro
+ *
+ * Created on October 17, 2026, 9:10 AM
+ */
+
+#ifndef STATISTICS_H
+#define	STATISTICS_H
+
+#include <string>
+#include <chrono>
+
+#define NSOS    (15)    // number of depths of the symbol perturbation
+
+#ifdef CONVEXHULL_STATS
+#define STATS_COUNT(c)      (Statistics::count(Statistics::Counter::c))
+#define STATS_SOS(d)        (Statistics::countSOS(d))
+#define STATS_TIMER(p)      Statistics::Timer stats_timer(Statistics::Phase::p)
+#else
+#define STATS_COUNT(c)
+#define STATS_SOS(d)
+#define STATS_TIMER(p)
+#endif
+
+using namespace std;
+
+class Statistics {
+public:
+    // counter of predicates
+    enum class Counter : int {
+        ORIENT,             // orientation predicates
+        FILTER,             // decided by the floating point filter
+        EXACT,              // fell back to the integer stage
+        NCOUNTER
+    };
+    // phase of the construction
+    enum class Phase : int {
+        CULL_VERTICES,
+        SORT_VERTICES,
+        CONST_INIT_HULLS,
+        SEARCH_SILHOUETTE,
+        SEARCH_CT_EDGE,
+        WRAP_IN_CYLINDRICAL,
+        DELETE_NON_HULL_PRIMS,
+        UPDATE_PRIMITIVES,
+        NPHASE
+    };
+    // counters and timers
+    struct Record {
+        long long kc[(int)Counter::NCOUNTER];   // counters of predicates
+        long long ksos[NSOS];                   // exact predicates by the depth of the symbol perturbation
+        long long kpn[(int)Phase::NPHASE];      // calls of phases
+        long long kpt[(int)Phase::NPHASE];      // nanoseconds of phases
+        Record();
+        void clear();
+        Record& operator +=(const Record& rhs);
+    };
+    // timer of the phase in the scope
+    class Timer {
+    public:
+        // starts the timer
+        // @param phase
+        Timer(Phase p) : phase(p), start(chrono::steady_clock::now()) {};
+        ~Timer();
+    private:
+        Phase phase;                            // phase
+        chrono::steady_clock::time_point start; // start time
+    };
+    // counts the predicate on the thread
+    // @param counter
+    static void count(Counter c) { local().kc[(int)c]++; };
+    // counts the depth of the symbol perturbation on the thread
+    // @param depth
+    static void countSOS(int d) { local().ksos[d]++; };
+    static bool enabled();
+    static void reset();
+    static Record collect();
+    static string toJSON(const Record& r);
+    virtual ~Statistics();
+private:
+    Statistics();
+    static Record& local();
+
+};
+
+#endif	/* STATISTICS_H */
+
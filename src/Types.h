@@ -0,0 +1,37 @@
+/*
+ * Types of the geometry core
+ *  - coordinates on the grid and ids of primitives are selected
+ *    at compile time, so that no kernel branches on them at run time
+ *  - CONVEXHULL_GRID32 (make GRID32=1) stores coordinates on the grid
+ *    in 32 bit integers, which halves the memory of vertices,
+ *    but coordinates must be less than 2^31 * PREC in magnitude,
+ *    vertices beyond GRIDMAX on the grid are rejected
+ *  - CONVEXHULL_ID64 (make ID64=1) numbers vertices, edges and faces
+ *    by 64 bit integers beyond 2^31 primitives
+ * File:   Types.h
+ * Author: munehiro
+ *
+ * Created on October 17, 2026, 9:10 AM
+ */
+
+#ifndef TYPES_H
+#define	TYPES_H
+
+typedef long long INT64;
+__extension__ typedef __int128 INT128;
+
+#if defined(CONVEXHULL_GRID32)
+typedef int GRID;       // coordinate on the grid
+#define GRIDMAX (2147483647.0)      // 2^31 - 1, maximum magnitude of coordinates on the grid
+#else
+typedef INT64 GRID;     // coordinate on the grid
+#define GRIDMAX (1099511627776.0)   // 2^40, maximum magnitude of coordinates on the grid
+#endif
+
+#if defined(CONVEXHULL_ID64)
+typedef long long ID;   // id of the primitive
+#else
+typedef int ID;         // id of the primitive
+#endif
+
+#endif	/* TYPES_H */
@@ -1,6 +1,9 @@
 /* 
  * 3d vector class
  *  - implements 3d vector operations
+ *  - is a standard layout and trivially copyable value of x, y and z
+ *    without the vtable, so that arrays of vectors are arrays of doubles,
+ *    and operations are inline loops which the compiler vectorizes
  * File:   Vector3d.h
  * Author: munehiro
  *
@@ -10,6 +13,8 @@
 #ifndef VECTOR3D_H
 #define	VECTOR3D_H
 
+#include <type_traits>
+
 class Vector3d {
 public:
     // less in x order
@@ -22,10 +27,8 @@ public:
             return (left.vec[2] < right.vec[2]);
         }
     };
-    Vector3d();
-    Vector3d(const Vector3d& orig);
-    Vector3d(double x, double y, double z);
-    virtual ~Vector3d();
+    Vector3d() : vec{ 0.0, 0.0, 0.0 } {};
+    Vector3d(double x, double y, double z) : vec{ x, y, z } {};
     // vector
     const double* get() const { return vec; };
     // x of the vector
@@ -34,26 +37,65 @@ public:
     double y() const { return vec[1]; };
     // z of the vector
     double z() const { return vec[2]; };
-    void set(double x, double y, double z);
-    bool operator ==(const Vector3d& rhs) const;
-    bool operator !=(const Vector3d& rhs) const;
-    Vector3d& operator =(const Vector3d& rhs);
-    Vector3d& operator +=(double rhs);
-    Vector3d operator +(double rhs) const;
-    Vector3d& operator +=(const Vector3d& rhs);
-    Vector3d operator +(const Vector3d& rhs) const;
-    Vector3d& operator -=(const Vector3d& rhs);
-    Vector3d operator -(const Vector3d& rhs) const;
-    Vector3d& operator *=(double rhs);
-    Vector3d operator *(double rhs) const;
-    Vector3d& operator /=(double rhs);
-    Vector3d operator /(double rhs) const;
-    double dot(const Vector3d& rhs) const;
-    Vector3d cross(const Vector3d& rhs) const;
+    void set(double x, double y, double z) { vec[0] = x; vec[1] = y; vec[2] = z; };
+    bool operator ==(const Vector3d& rhs) const {
+        return (vec[0] == rhs.vec[0] && vec[1] == rhs.vec[1] && vec[2] == rhs.vec[2]);
+    };
+    bool operator !=(const Vector3d& rhs) const { return !(*this == rhs); };
+    Vector3d& operator +=(double rhs) {
+        for (int k = 0; k < 3; k++) {
+            vec[k] += rhs;
+        }
+        return *this;
+    };
+    Vector3d operator +(double rhs) const { return Vector3d(*this) += rhs; };
+    Vector3d& operator +=(const Vector3d& rhs) {
+        for (int k = 0; k < 3; k++) {
+            vec[k] += rhs.vec[k];
+        }
+        return *this;
+    };
+    Vector3d operator +(const Vector3d& rhs) const { return Vector3d(*this) += rhs; };
+    Vector3d& operator -=(const Vector3d& rhs) {
+        for (int k = 0; k < 3; k++) {
+            vec[k] -= rhs.vec[k];
+        }
+        return *this;
+    };
+    Vector3d operator -(const Vector3d& rhs) const { return Vector3d(*this) -= rhs; };
+    Vector3d& operator *=(double rhs) {
+        for (int k = 0; k < 3; k++) {
+            vec[k] *= rhs;
+        }
+        return *this;
+    };
+    Vector3d operator *(double rhs) const { return Vector3d(*this) *= rhs; };
+    Vector3d& operator /=(double rhs) {
+        for (int k = 0; k < 3; k++) {
+            vec[k] /= rhs;
+        }
+        return *this;
+    };
+    Vector3d operator /(double rhs) const { return Vector3d(*this) /= rhs; };
+    // dot production
+    double dot(const Vector3d& rhs) const {
+        return (vec[0] * rhs.vec[0] + vec[1] * rhs.vec[1] + vec[2] * rhs.vec[2]);
+    };
+    // cross production
+    Vector3d cross(const Vector3d& rhs) const {
+        return Vector3d(vec[1] * rhs.vec[2] - vec[2] * rhs.vec[1],
+                        vec[2] * rhs.vec[0] - vec[0] * rhs.vec[2],
+                        vec[0] * rhs.vec[1] - vec[1] * rhs.vec[0]);
+    };
 private:
     double vec[3];  // x, y and z of the vector
 
 };
 
+// arrays of vectors are viewed and copied as arrays of x, y and z
+static_assert(std::is_standard_layout<Vector3d>::value && std::is_trivially_copyable<Vector3d>::value,
+              "Vector3d must be a plain value");
+static_assert(sizeof(Vector3d) == 3 * sizeof(double), "Vector3d must be x, y and z");
+
 #endif	/* VECTOR3D_H */
 
@@ -0,0 +1,205 @@
+/*
+ * File:   VertexFile.cpp
+ * Author: munehiro
+ *
+ * Created on October 17, 2026, 9:10 AM
+ */
+
+#include <sstream>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "VertexFile.h"
+
+#define NHDR    (65536)         // max length of the PLY header
+
+/**
+ * Gets bytes of the PLY property type
+ * @param type
+ * @return bytes, or 0 if unknown
+ */
+static size_t sizeOfPLYType(const string& t) {
+    if (t == "char" || t == "uchar" || t == "int8" || t == "uint8") {
+        return 1;
+    } else if (t == "short" || t == "ushort" || t == "int16" || t == "uint16") {
+        return 2;
+    } else if (t == "int" || t == "uint" || t == "float" || t == "int32" || t == "uint32" || t == "float32") {
+        return 4;
+    } else if (t == "double" || t == "float64") {
+        return 8;
+    }
+    return 0;
+}
+
+/**
+ * Constructor and Destructor
+ */
+VertexFile::VertexFile() : addr(nullptr), len(0) {
+}
+
+VertexFile::~VertexFile() {
+    close();
+}
+
+/**
+ * Opens the file and maps it on the memory
+ * @param file name
+ * @param format of the file
+ * @return succeeded or not
+ */
+bool VertexFile::open(const string& fn, Format fmt) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+    // reads little endian numbers as they are
+    return false;
+#endif
+    close();
+    int fd = ::open(fn.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    len = st.st_size;
+    addr = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping remains after the file is closed
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        addr = nullptr;
+        len = 0;
+        return false;
+    }
+    bool ok = false;
+    if (fmt == Format::PLY) {
+        ok = parsePLY();
+    } else {
+        size_t w = (fmt == Format::RAW64 ? sizeof(double) : sizeof(float));
+        ok = (len % (3 * w) == 0);
+        view = VertexView(addr, len / (3 * w), 3 * w,
+                          (fmt == Format::RAW64 ? VertexView::Type::FLOAT64 : VertexView::Type::FLOAT32));
+    }
+    if (!ok) {
+        close();
+        return false;
+    }
+    // vertices are snapped on the grid in a single pass in order
+    // (chunk by chunk on the append), which the read ahead serves,
+    // then only vertices on the convex hull are read again by the writer
+    madvise(addr, len, MADV_WILLNEED);
+    return true;
+}
+
+/**
+ * Unmaps the file
+ */
+void VertexFile::close() {
+    if (addr) {
+        munmap(addr, len);
+        addr = nullptr;
+        len = 0;
+    }
+    view = VertexView();
+}
+
+/**
+ * Parses the header of the PLY
+ *  - x, y and z must be adjacent float or double properties of vertices
+ *  - elements before vertices must not have list properties
+ *  - counts of elements are checked against the length of the file
+ *    before they are multiplied
+ * @return succeeded or not
+ */
+bool VertexFile::parsePLY() {
+    const char* p = (const char*)addr;
+    string hdr(p, min(len, (size_t)NHDR));
+    size_t eoh = hdr.find("\nend_header");
+    size_t eol = (eoh == string::npos ? eoh : hdr.find('\n', eoh + 1));
+    if (hdr.compare(0, 3, "ply") != 0 || eol == string::npos) {
+        return false;
+    }
+    size_t ofs = eol + 1;       // offset of the element
+    size_t nv = 0;              // number of vertices
+    size_t stride = 0;          // bytes of the vertex
+    size_t xofs = 0;            // offset of x in the vertex
+    string xtype;               // type of x
+    int nxyz = 0;               // number of found x, y and z
+    size_t ne = 0;              // number of the current element
+    size_t se = 0;              // bytes of the current element
+    bool vertex = false;        // the current element is vertices or not
+    bool binary = false;
+    istringstream is(hdr.substr(0, eoh));
+    string line;
+    while (getline(is, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        istringstream ls(line);
+        string key;
+        ls >> key;
+        if (key == "format") {
+            string f;
+            ls >> f;
+            binary = (f == "binary_little_endian");
+        } else if (key == "element") {
+            // the former element is before vertices
+            if (!vertex && nv == 0) {
+                if (se > 0 && ne > (len - ofs) / se) {
+                    return false;
+                }
+                ofs += ne * se;
+            }
+            string name;
+            long long n;
+            if (!(ls >> name >> n) || n < 0) {
+                return false;
+            }
+            ne = (size_t)n;
+            se = 0;
+            vertex = (name == "vertex");
+            if (vertex) {
+                nv = ne;
+            }
+        } else if (key == "property") {
+            string t, name;
+            ls >> t >> name;
+            if (t == "list") {
+                // elements after vertices may have lists
+                if (vertex || nv == 0) {
+                    return false;
+                }
+                continue;
+            }
+            size_t w = sizeOfPLYType(t);
+            if (w == 0) {
+                return false;
+            }
+            if (vertex) {
+                if (name == "x" && nxyz == 0) {
+                    xofs = se;
+                    xtype = t;
+                    nxyz++;
+                } else if ((name == "y" && nxyz == 1) || (name == "z" && nxyz == 2)) {
+                    if (t != xtype || se != xofs + nxyz * w) {
+                        return false;
+                    }
+                    nxyz++;
+                } else if (name == "x" || name == "y" || name == "z") {
+                    return false;
+                }
+                stride = se + w;
+            }
+            se += w;
+        }
+    }
+    bool f32 = (xtype == "float" || xtype == "float32");
+    bool f64 = (xtype == "double" || xtype == "float64");
+    if (!binary || nv == 0 || nxyz != 3 || !(f32 || f64) || nv > (len - ofs) / stride) {
+        return false;
+    }
+    view = VertexView(p + ofs + xofs, nv, stride, (f64 ? VertexView::Type::FLOAT64 : VertexView::Type::FLOAT32));
+    return true;
+}
@@ -0,0 +1,46 @@
+/*
+ * Vertex file class
+ *  - maps the file of vertices on the memory
+ *  - reads raw little endian float64 or float32 x, y and z,
+ *    or the binary little endian PLY with x, y and z of vertices
+ * File:   VertexFile.h
+ * Author: munehiro
+ *
+ * Created on October 17, 2026, 9:10 AM
+ */
+
+#ifndef VERTEXFILE_H
+#define	VERTEXFILE_H
+
+#include <string>
+#include "VertexView.h"
+
+using namespace std;
+
+class VertexFile {
+public:
+    // format of the file
+    enum class Format : int {
+        RAW64,      // raw float64 x, y and z
+        RAW32,      // raw float32 x, y and z
+        PLY         // binary little endian PLY
+    };
+    VertexFile();
+    virtual ~VertexFile();
+    bool open(const string& fn, Format fmt);
+    void close();
+    // vertices in the file, valid until the file is closed
+    // @return vertices
+    const VertexView& vertices() const { return view; };
+private:
+    VertexFile(const VertexFile& orig);
+    VertexFile& operator =(const VertexFile& rhs);
+    bool parsePLY();
+    void* addr;             // address of the mapped file
+    size_t len;             // length of the mapped file
+    VertexView view;        // vertices in the file
+
+};
+
+#endif	/* VERTEXFILE_H */
+
@@ -0,0 +1,64 @@
+/*
+ * Vertex view class
+ *  - refers to x, y and z of vertices in the external memory
+ *    (e.g. the memory mapped file) without copies
+ *  - x, y and z are adjacent 32 or 64 bit floating point numbers
+ *    at the offset of each record of the stride
+ * File:   VertexView.h
+ * Author: munehiro
+ *
+ * Created on October 17, 2026, 9:10 AM
+ */
+
+#ifndef VERTEXVIEW_H
+#define	VERTEXVIEW_H
+
+#include <cstddef>
+#include <cstring>
+
+class VertexView {
+public:
+    // type of coordinates
+    enum class Type : int {
+        FLOAT32,
+        FLOAT64
+    };
+    VertexView() : data(nullptr), nv(0), stride(0), type(Type::FLOAT64) {};
+    // @param first coordinate of the first vertex
+    // @param number of vertices
+    // @param bytes between vertices
+    // @param type of coordinates
+    VertexView(const void* p, size_t n, size_t s, Type t) : data((const char*)p), nv(n), stride(s), type(t) {};
+    virtual ~VertexView() {};
+    // @return number of vertices
+    size_t size() const { return nv; };
+    // @param first vertex
+    // @param number of vertices
+    // @return view of vertices from the first vertex
+    VertexView slice(size_t iv, size_t n) const { return VertexView(data + iv * stride, n, stride, type); };
+    // gets coordinates of the vertex
+    //  - copies bytes, records of the file may be unaligned
+    // @param vertex
+    // @param x, y and z
+    void get(size_t iv, double* v) const {
+        const char* p = data + iv * stride;
+        if (type == Type::FLOAT64) {
+            memcpy(v, p, 3 * sizeof(double));
+        } else {
+            float f[3];
+            memcpy(f, p, 3 * sizeof(float));
+            v[0] = f[0];
+            v[1] = f[1];
+            v[2] = f[2];
+        }
+    };
+private:
+    const char* data;       // first coordinate of the first vertex
+    size_t nv;              // number of vertices
+    size_t stride;          // bytes between vertices
+    Type type;              // type of coordinates
+
+};
+
+#endif	/* VERTEXVIEW_H */
+
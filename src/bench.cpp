@@ -0,0 +1,331 @@
+/*
+ * Benchmark
+ *  - constructs the 3d convex hull over distributions and sizes of vertices
+ *  - reports each run as a line of JSON
+ * File:   bench.cpp
+ * Author: munehiro
+ *
+ * Created on October 17, 2026, 9:10 AM
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include "ConvexHull.h"
+#include "Vector3d.h"
+
+using namespace std;
+
+#define NCLST   (16)            // number of clusters
+#define NBUF    (4096)          // size of the buffer of a result
+
+// distributions of vertices
+static const char* const DISTS[] = {
+    "ball", "sphere", "cube", "gauss", "cluster", "grid", "cosphere"
+};
+static const int NDIST = sizeof(DISTS) / sizeof(DISTS[0]);
+
+/**
+ * Prints usage
+ * @param program name
+ */
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -D dists    comma separated distributions (default: all)\n"
+            "              ball, sphere, cube, gauss, cluster, grid, cosphere\n"
+            "  -n sizes    comma separated numbers of vertices\n"
+            "              (default: 1000,10000,100000,1000000,10000000)\n"
+            "  -r repeats  number of runs of each case (default: 1)\n"
+            "  -s seed     seed of the first run (default: 1)\n"
+            "  -t threads  number of threads (default: hardware concurrency)\n"
+            "  -d          merges convex hulls depth first\n"
+            "  -a dirs     culls interior vertices by extreme vertices along 6 or 26 directions\n"
+            "  -T seconds  time limit of a run (default: 600)\n"
+            "counters and timers of the construction are reported if built with make STATS=1\n", prog);
+}
+
+/**
+ * Splits the comma separated list
+ * @param list
+ * @return items
+ */
+static vector<string> split(const char* s) {
+    vector<string> ks;
+    string t(s);
+    size_t p = 0;
+    while (p <= t.size()) {
+        size_t q = t.find(',', p);
+        if (q == string::npos) {
+            q = t.size();
+        }
+        if (q > p) {
+            ks.push_back(t.substr(p, q - p));
+        }
+        p = q + 1;
+    }
+    return ks;
+}
+
+/**
+ * Generates vertices
+ * @param distribution
+ * @param number of vertices
+ * @param seed
+ * @param vertex array
+ */
+static void generateVertices(const string& dist, int nv, int seed, vector<Vector3d>& va) {
+    mt19937_64 rng(seed);
+    uniform_real_distribution<double> uni(-1.0, 1.0);
+    normal_distribution<double> gauss(0.0, 1.0);
+    va.reserve(nv);
+    if (dist == "grid") {
+        // lattice points of the cube, all degenerate
+        int nd = max(2, (int)ceil(cbrt((double)nv)));
+        for (int i = 0; i < nd && (int)va.size() < nv; i++) {
+            for (int j = 0; j < nd && (int)va.size() < nv; j++) {
+                for (int k = 0; k < nd && (int)va.size() < nv; k++) {
+                    va.push_back(Vector3d(i, j, k) * (2.0 / (nd - 1)) + (-1.0));
+                }
+            }
+        }
+        return;
+    }
+    Vector3d kc[NCLST];
+    for (int i = 0; i < NCLST; i++) {
+        kc[i] = Vector3d(uni(rng), uni(rng), uni(rng)) * 0.8;
+    }
+    for (int i = 0; i < nv; i++) {
+        double x, y, z;
+        if (dist == "cube") {
+            x = uni(rng);
+            y = uni(rng);
+            z = uni(rng);
+        } else if (dist == "gauss") {
+            x = gauss(rng);
+            y = gauss(rng);
+            z = gauss(rng);
+        } else if (dist == "cluster") {
+            const Vector3d& c = kc[rng() % NCLST];
+            x = c.x() + gauss(rng) * 0.02;
+            y = c.y() + gauss(rng) * 0.02;
+            z = c.z() + gauss(rng) * 0.02;
+        } else {
+            do {
+                x = uni(rng);
+                y = uni(rng);
+                z = uni(rng);
+            } while ((x * x + y * y + z * z) > 1.0 || (x * x + y * y + z * z) == 0.0);
+            if (dist == "sphere" || dist == "cosphere") {
+                double l = sqrt(x * x + y * y + z * z);
+                x /= l;
+                y /= l;
+                z /= l;
+            }
+            if (dist == "cosphere") {
+                // snaps to the coarse grid, many vertices are coplanar or share x
+                x = round(x * 1.0e3) / 1.0e3;
+                y = round(y * 1.0e3) / 1.0e3;
+                z = round(z * 1.0e3) / 1.0e3;
+            }
+        }
+        va.push_back(Vector3d(x, y, z));
+    }
+}
+
+/**
+ * Gets seconds between time points
+ * @param start time point
+ * @param end time point
+ * @return seconds
+ */
+static double seconds(chrono::steady_clock::time_point t0, chrono::steady_clock::time_point t1) {
+    return chrono::duration<double>(t1 - t0).count();
+}
+
+/**
+ * Gets peak resident set size
+ * @return peak resident set size in KB
+ */
+static long peakRSS() {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+}
+
+/**
+ * Runs a case and writes the result
+ * @param distribution
+ * @param number of vertices
+ * @param seed
+ * @param number of threads
+ * @param merges depth first or not
+ * @param directions of extreme vertices to cull interior vertices
+ * @param buffer of the result
+ */
+static void run(const string& dist, int nv, int seed, int nt, bool df, ConvexHull::Culling cl, char* buf) {
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    vector<Vector3d> va;
+    generateVertices(dist, nv, seed, va);
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+    long rss0 = peakRSS();
+    ConvexHull ch;
+    ch.setThreads(nt);
+    ch.setMergeOrder(df ? ConvexHull::MergeOrder::DEPTH_FIRST : ConvexHull::MergeOrder::BREADTH_FIRST);
+    ch.setCulling(cl);
+    // sorts vertices in x order and removes duplicates
+    bool ok = ch.construct(va);
+    chrono::steady_clock::time_point t3 = chrono::steady_clock::now();
+    if (!ok) {
+        // too many vertices for ids or vertices out of the range of the grid
+        snprintf(buf, NBUF, "\"status\":\"error\",\"vertices\":%zu,\"generate_s\":%.6f,\"construct_s\":%.6f",
+                 va.size(), seconds(t0, t1), seconds(t1, t3));
+        return;
+    }
+    // extracts the indexed mesh as writers of the convex hull do
+    ConvexHull::Mesh mesh;
+    ch.extract(mesh);
+    chrono::steady_clock::time_point t4 = chrono::steady_clock::now();
+    double tch = seconds(t1, t3);
+    snprintf(buf, NBUF,
+             "\"status\":\"ok\",\"vertices\":%zu,"
+             "\"hull_vertices\":%zu,\"hull_edges\":%zu,\"hull_faces\":%zu,"
+             "\"generate_s\":%.6f,\"construct_s\":%.6f,\"extract_s\":%.6f,"
+             "\"points_per_s\":%.0f,\"input_rss_kb\":%ld,\"peak_rss_kb\":%ld,\"stats\":%s",
+             va.size(), mesh.kvi.size(), mesh.ke.size() / 2, mesh.kt.size() / 3,
+             seconds(t0, t1), tch, seconds(t3, t4),
+             va.size() / tch, rss0, peakRSS(), Statistics::toJSON(ch.statistics()).c_str());
+}
+
+/**
+ * Runs a case in the child process
+ *  - isolates the peak resident set size, the time limit and crashes
+ * @param distribution
+ * @param number of vertices
+ * @param seed
+ * @param number of threads
+ * @param merges depth first or not
+ * @param directions of extreme vertices to cull interior vertices
+ * @param time limit in seconds
+ */
+static void runChild(const string& dist, int nv, int seed, int nt, bool df, ConvexHull::Culling cl, int tl) {
+    char buf[NBUF] = "";
+    int fd[2];
+    if (pipe(fd) != 0) {
+        perror("pipe");
+        exit(-1);
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        exit(-1);
+    }
+    if (pid == 0) {
+        close(fd[0]);
+        alarm(tl);
+        run(dist, nv, seed, nt, df, cl, buf);
+        ssize_t n = write(fd[1], buf, strlen(buf));
+        _exit(n < 0 ? -1 : 0);
+    }
+    close(fd[1]);
+    size_t n = 0;
+    ssize_t r;
+    while (n < NBUF - 1 && (r = read(fd[0], buf + n, NBUF - 1 - n)) > 0) {
+        n += r;
+    }
+    buf[n] = '\0';
+    close(fd[0]);
+    int st = 0;
+    waitpid(pid, &st, 0);
+    if (WIFSIGNALED(st)) {
+        snprintf(buf, NBUF, "\"status\":\"%s\",\"signal\":%d",
+                 (WTERMSIG(st) == SIGALRM ? "timeout" : "crash"), WTERMSIG(st));
+    } else if (n == 0) {
+        snprintf(buf, NBUF, "\"status\":\"error\",\"exit\":%d", WEXITSTATUS(st));
+    }
+    printf("{\"dist\":\"%s\",\"n\":%d,\"seed\":%d,\"threads\":%d,\"order\":\"%s\",\"culling\":\"%s\",%s}\n",
+           dist.c_str(), nv, seed, nt, (df ? "depth" : "breadth"),
+           (cl == ConvexHull::Culling::OCTAHEDRON ? "octahedron" :
+            cl == ConvexHull::Culling::POLYTOPE26 ? "polytope26" : "none"), buf);
+    fflush(stdout);
+}
+
+/*
+ *
+ */
+int main(int argc, char** argv) {
+    vector<string> kd(DISTS, DISTS + NDIST);
+    vector<int> kn = { 1000, 10000, 100000, 1000000, 10000000 };
+    int nr = 1;
+    int seed = 1;
+    int nt = thread::hardware_concurrency();
+    bool df = false;
+    ConvexHull::Culling cl = ConvexHull::Culling::NONE;
+    int tl = 600;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-D") == 0 && i + 1 < argc) {
+            kd = split(argv[++i]);
+            for (size_t j = 0; j < kd.size(); j++) {
+                if (find(DISTS, DISTS + NDIST, kd[j]) == DISTS + NDIST) {
+                    fprintf(stderr, "%s: unknown distribution %s\n", argv[0], kd[j].c_str());
+                    return -1;
+                }
+            }
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            vector<string> ks = split(argv[++i]);
+            kn.clear();
+            for (size_t j = 0; j < ks.size(); j++) {
+                kn.push_back((int)atof(ks[j].c_str()));
+            }
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            nr = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            nt = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-d") == 0) {
+            df = true;
+        } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            int na = atoi(argv[++i]);
+            if (na != 6 && na != 26) {
+                usage(argv[0]);
+                return -1;
+            }
+            cl = (na == 6 ? ConvexHull::Culling::OCTAHEDRON : ConvexHull::Culling::POLYTOPE26);
+        } else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc) {
+            tl = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+    // initial convex hulls need at least 7 vertices as the spin button of the GUI
+    for (size_t j = 0; j < kn.size(); j++) {
+        if (kn[j] < 7) {
+            fprintf(stderr, "%s: at least 7 vertices are needed\n", argv[0]);
+            return -1;
+        }
+    }
+    nt = max(nt, 1);
+
+    for (size_t i = 0; i < kd.size(); i++) {
+        for (size_t j = 0; j < kn.size(); j++) {
+            for (int k = 0; k < nr; k++) {
+                runChild(kd[i], kn[j], seed + k, nt, df, cl, tl);
+            }
+        }
+    }
+    return 0;
+}
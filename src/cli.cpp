@@ -0,0 +1,255 @@
+/*
+ * Command line interface
+ *  - constructs the 3d convex hull without the GUI
+ * File:   cli.cpp
+ * Author: munehiro
+ *
+ * Created on October 17, 2026, 9:10 AM
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "ConvexHull.h"
+#include "VertexFile.h"
+#include "MeshWriter.h"
+
+using namespace std;
+
+/**
+ * Prints usage
+ * @param program name
+ */
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "usage: %s [options] <input | -n number> [output]\n"
+            "  input       file of vertices ('-' for stdin of text)\n"
+            "  output      file of the convex hull, binary PLY (.ply), binary STL (.stl)\n"
+            "              or Wavefront OBJ (otherwise)\n"
+            "  -n number   generates number of vertices in the unit ball\n"
+            "  -t threads  number of threads (default: hardware concurrency)\n"
+            "  -d          merges convex hulls depth first\n"
+            "  -a dirs     culls interior vertices by extreme vertices along 6 or 26 directions\n"
+            "  -f format   format of the input: txt (x y z per line), f64, f32 or ply\n"
+            "              (default: by the extension, .f64, .f32, .ply or text)\n"
+            "  -c chunk    appends chunks of vertices of the input in x order\n"
+            "              to the convex hull as a stream\n"
+            "  -j file     writes counters and timers of the construction in JSON\n"
+            "              ('-' for stdout, needs make STATS=1)\n", prog);
+}
+
+/**
+ * Reads vertices from the text file
+ * @param file name
+ * @param x, y and z of vertices
+ * @return succeeded or not
+ */
+static bool readVertices(const char* fn, vector<double>& va) {
+    FILE* fp = (strcmp(fn, "-") == 0 ? stdin : fopen(fn, "r"));
+    if (!fp) {
+        return false;
+    }
+    double x, y, z;
+    while (fscanf(fp, "%lf %lf %lf", &x, &y, &z) == 3) {
+        va.push_back(x);
+        va.push_back(y);
+        va.push_back(z);
+    }
+    if (fp != stdin) {
+        fclose(fp);
+    }
+    return true;
+}
+
+/**
+ * Generates vertices in the unit ball
+ * @param number of vertices
+ * @param x, y and z of vertices
+ */
+static void generateVertices(int nv, vector<double>& va) {
+    mt19937_64 rng(random_device{}());
+    uniform_real_distribution<double> dist(-1.0, 1.0);
+    va.reserve(3 * nv);
+    for (int i = 0; i < nv; i++) {
+        double x, y, z;
+        do {
+            x = dist(rng);
+            y = dist(rng);
+            z = dist(rng);
+        } while ((x * x + y * y + z * z) > 1.0);
+        va.push_back(x);
+        va.push_back(y);
+        va.push_back(z);
+    }
+}
+
+/**
+ * Gets the format of the file by the extension
+ * @param file name
+ * @param format
+ * @return binary or not
+ */
+static bool formatOf(const string& fn, VertexFile::Format& fmt) {
+    size_t p = fn.rfind('.');
+    string ext = (p == string::npos ? "" : fn.substr(p + 1));
+    if (ext == "f64") {
+        fmt = VertexFile::Format::RAW64;
+    } else if (ext == "f32") {
+        fmt = VertexFile::Format::RAW32;
+    } else if (ext == "ply") {
+        fmt = VertexFile::Format::PLY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/*
+ *
+ */
+int main(int argc, char** argv) {
+    int nt = thread::hardware_concurrency();
+    int ng = 0;
+    int nc = 0;
+    bool df = false;
+    ConvexHull::Culling cl = ConvexHull::Culling::NONE;
+    const char* ifn = nullptr;
+    const char* ofn = nullptr;
+    const char* jfn = nullptr;
+    const char* fmt = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            nt = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            ng = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-d") == 0) {
+            df = true;
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            fmt = argv[++i];
+        } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            int na = atoi(argv[++i]);
+            if (na != 6 && na != 26) {
+                usage(argv[0]);
+                return -1;
+            }
+            cl = (na == 6 ? ConvexHull::Culling::OCTAHEDRON : ConvexHull::Culling::POLYTOPE26);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            nc = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            jfn = argv[++i];
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            usage(argv[0]);
+            return -1;
+        } else if (!ifn && ng == 0) {
+            ifn = argv[i];
+        } else if (!ofn) {
+            ofn = argv[i];
+        } else {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+    if (!ifn && ng <= 0) {
+        usage(argv[0]);
+        return -1;
+    }
+
+    // reads or generates vertices
+    //  - binary files are mapped on the memory and read by the convex hull directly
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    vector<double> va;
+    VertexFile vf;
+    VertexView vw;
+    VertexFile::Format ff;
+    bool binary = false;
+    if (fmt && strcmp(fmt, "txt") != 0) {
+        binary = formatOf(string(".") + fmt, ff);
+        if (!binary) {
+            usage(argv[0]);
+            return -1;
+        }
+    } else if (!fmt && ifn) {
+        binary = formatOf(ifn, ff);
+    }
+    if (ifn && binary) {
+        if (!vf.open(ifn, ff)) {
+            fprintf(stderr, "%s: cannot read %s\n", argv[0], ifn);
+            return -1;
+        }
+        vw = vf.vertices();
+    } else {
+        if (ifn && !readVertices(ifn, va)) {
+            fprintf(stderr, "%s: cannot read %s\n", argv[0], ifn);
+            return -1;
+        } else if (!ifn) {
+            generateVertices(ng, va);
+        }
+        vw = VertexView(va.data(), va.size() / 3, 3 * sizeof(double), VertexView::Type::FLOAT64);
+    }
+
+    // constructs the 3d convex hull
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+    ConvexHull ch;
+    ch.setThreads(nt);
+    ch.setMergeOrder(df ? ConvexHull::MergeOrder::DEPTH_FIRST : ConvexHull::MergeOrder::BREADTH_FIRST);
+    ch.setCulling(cl);
+    bool ok = true;
+    if (nc > 0) {
+        // appends chunks of vertices, the convex hull is current after each chunk
+        for (size_t i = 0; i < vw.size() && ok; i += nc) {
+            ok = ch.append(vw.slice(i, min(vw.size() - i, (size_t)nc)));
+        }
+    } else {
+        // sorts vertices in x order and removes duplicates
+        ok = ch.construct(vw);
+    }
+    chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+    if (!ok) {
+        fprintf(stderr, "%s: too many vertices or vertices out of the range of the grid\n", argv[0]);
+        return -1;
+    }
+    // initial convex hulls need at least 7 vertices as the spin button of the GUI
+    if (ch.faces().empty()) {
+        fprintf(stderr, "%s: at least 7 distinct vertices are needed\n", argv[0]);
+        return -1;
+    }
+
+    // writes the convex hull
+    string ext = (ofn && strrchr(ofn, '.') ? strrchr(ofn, '.') + 1 : "");
+    MeshWriter mw;
+    if (ofn && !mw.write(ofn, (ext == "ply" ? MeshWriter::Format::PLY :
+                               ext == "stl" ? MeshWriter::Format::STL : MeshWriter::Format::OBJ), ch, vw)) {
+        fprintf(stderr, "%s: cannot write %s\n", argv[0], ofn);
+        return -1;
+    }
+    chrono::steady_clock::time_point t3 = chrono::steady_clock::now();
+
+    double tin = chrono::duration<double>(t1 - t0).count();
+    double tch = chrono::duration<double>(t2 - t1).count();
+    double tout = chrono::duration<double>(t3 - t2).count();
+    printf("vertices:    %zu\n", vw.size());
+    printf("faces:       %zu\n", ch.faces().size());
+    printf("input:       %.3f s\n", tin);
+    printf("construct:   %.3f s\n", tch);
+    printf("output:      %.3f s\n", tout);
+    printf("wall:        %.3f s\n", tin + tch + tout);
+    printf("throughput:  %.0f vertices/s\n", vw.size() / tch);
+
+    // writes counters and timers of the construction
+    if (jfn) {
+        FILE* fp = (strcmp(jfn, "-") == 0 ? stdout : fopen(jfn, "w"));
+        if (!fp) {
+            fprintf(stderr, "%s: cannot write %s\n", argv[0], jfn);
+            return -1;
+        }
+        fprintf(fp, "%s\n", Statistics::toJSON(ch.statistics()).c_str());
+        if (fp != stdout) {
+            fclose(fp);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,483 @@
+/*
+ * Tests
+ *  - constructs the 3d convex hull of degenerate vertices
+ *    on 1 and more threads, and checks the result
+ *  - culls interior vertices, inserts vertices one by one
+ *    and appends chunks of vertices, and checks the result
+ *  - rejects inputs beyond limits of ids, files and the grid
+ *  - exits with the number of failed tests
+ * File:   test.cpp
+ * Author: munehiro
+ *
+ * Created on October 17, 2026, 9:10 AM
+ */
+
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include "ConvexHull.h"
+#include "Vector3d.h"
+#include "VertexFile.h"
+
+using namespace std;
+
+#define UNIT    (1.0e3)         // inverse of the unit of coordinates of test vertices
+#ifdef CONVEXHULL_PREC
+#define PREC    (CONVEXHULL_PREC) // precision of the grid of the convex hull
+#else
+#define PREC    (1.0e-6)        // precision of the grid of the convex hull
+#endif
+
+/**
+ * Generates lattice points of the cube
+ * @param number of points along each axis
+ * @param vertices
+ */
+static void generateGrid(int nd, vector<Vector3d>& va) {
+    va.clear();
+    for (int i = 0; i < nd; i++) {
+        for (int j = 0; j < nd; j++) {
+            for (int k = 0; k < nd; k++) {
+                va.push_back(Vector3d(i, j, k) * 0.1);
+            }
+        }
+    }
+}
+
+/**
+ * Generates points on the sphere snapped to the coarse grid
+ * @param number of vertices
+ * @param vertices
+ */
+static void generateCosphere(int nv, vector<Vector3d>& va) {
+    mt19937 rng(1);
+    normal_distribution<double> gauss(0.0, 1.0);
+    va.clear();
+    while ((int)va.size() < nv) {
+        double x = gauss(rng), y = gauss(rng), z = gauss(rng);
+        double l = sqrt(x * x + y * y + z * z);
+        if (l == 0.0) {
+            continue;
+        }
+        va.push_back(Vector3d(round(x / l * 1.0e2) / 1.0e2,
+                              round(y / l * 1.0e2) / 1.0e2,
+                              round(z / l * 1.0e2) / 1.0e2));
+    }
+}
+
+/**
+ * Generates points in the cube uniformly
+ *  - coordinates are in UNIT, so that the judge is exact
+ * @param number of vertices
+ * @param seed of the random numbers
+ * @param vertices
+ */
+static void generateUniform(int nv, int seed, vector<Vector3d>& va) {
+    mt19937 rng(seed);
+    uniform_real_distribution<double> uniform(-1.0, 1.0);
+    va.clear();
+    for (int i = 0; i < nv; i++) {
+        double x = uniform(rng), y = uniform(rng), z = uniform(rng);
+        va.push_back(Vector3d(round(x * UNIT) / UNIT, round(y * UNIT) / UNIT, round(z * UNIT) / UNIT));
+    }
+}
+
+/**
+ * Is the mesh the convex hull of vertices
+ *  - every edge is shared by 2 triangles in opposite directions,
+ *    V - E + F = 2, and no vertex is in front of any triangle
+ *  - coordinates are integers in UNIT, so that the judge is exact
+ * @param vertices
+ * @param mesh
+ * @return convex hull or not
+ */
+static bool isConvexHull(const vector<Vector3d>& va, const ConvexHull::Mesh& mesh) {
+    vector<long long> g(3 * va.size());
+    for (size_t i = 0; i < va.size(); i++) {
+        for (int k = 0; k < 3; k++) {
+            g[3*i+k] = llround(va[i].get()[k] * UNIT);
+        }
+    }
+    ID nf = mesh.kt.size() / 3;
+    map<pair<ID, ID>, int> kne;
+    for (ID f = 0; f < nf; f++) {
+        for (int i = 0; i < 3; i++) {
+            kne[make_pair(mesh.kt[3*f+i], mesh.kt[3*f+(i+1)%3])]++;
+        }
+    }
+    for (const auto& ne : kne) {
+        if (ne.second != 1 || kne.count(make_pair(ne.first.second, ne.first.first)) == 0) {
+            return false;
+        }
+    }
+    if ((ID)mesh.kvi.size() - (ID)kne.size() / 2 + nf != 2) {
+        return false;
+    }
+    for (ID f = 0; f < nf; f++) {
+        const long long* a = &g[3 * mesh.kvi[mesh.kt[3*f]]];
+        const long long* b = &g[3 * mesh.kvi[mesh.kt[3*f+1]]];
+        const long long* c = &g[3 * mesh.kvi[mesh.kt[3*f+2]]];
+        INT128 ab[] = { (INT128)b[0] - a[0], (INT128)b[1] - a[1], (INT128)b[2] - a[2] };
+        INT128 ac[] = { (INT128)c[0] - a[0], (INT128)c[1] - a[1], (INT128)c[2] - a[2] };
+        INT128 n[] = { ab[1] * ac[2] - ab[2] * ac[1],
+                       ab[2] * ac[0] - ab[0] * ac[2],
+                       ab[0] * ac[1] - ab[1] * ac[0] };
+        for (size_t i = 0; i < va.size(); i++) {
+            const long long* p = &g[3*i];
+            if (n[0] * (p[0] - a[0]) + n[1] * (p[1] - a[1]) + n[2] * (p[2] - a[2]) > 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Constructs the convex hull and checks it
+ * @param vertices
+ * @param number of threads
+ * @param order of merges
+ * @return passed or not
+ */
+static bool testConstruct(const vector<Vector3d>& va, int nt, ConvexHull::MergeOrder mo) {
+    ConvexHull ch;
+    ch.setThreads(nt);
+    ch.setMergeOrder(mo);
+    if (!ch.construct(va)) {
+        return false;
+    }
+    ConvexHull::Mesh mesh;
+    ch.extract(mesh);
+    return isConvexHull(va, mesh);
+}
+
+/**
+ * Gets triangles of the mesh in indices of the input
+ *  - each triangle starts from the least index, and triangles are sorted,
+ *    so that meshes of the same convex hull are equal
+ * @param mesh
+ * @return triangles
+ */
+static vector<array<ID, 3>> getTriangles(const ConvexHull::Mesh& mesh) {
+    vector<array<ID, 3>> kt;
+    for (size_t i = 0; i < mesh.kt.size(); i += 3) {
+        array<ID, 3> t = { { mesh.kvi[mesh.kt[i]], mesh.kvi[mesh.kt[i+1]], mesh.kvi[mesh.kt[i+2]] } };
+        rotate(t.begin(), min_element(t.begin(), t.end()), t.end());
+        kt.push_back(t);
+    }
+    sort(kt.begin(), kt.end());
+    return kt;
+}
+
+/**
+ * Sorts vertices on threads and checks the convex hull
+ *  - more vertices than 2 * NSORT are sorted by the sample sort on threads,
+ *    duplicates across buckets are removed, and the convex hull is the same
+ *    as that of vertices sorted on 1 thread
+ * @param vertices
+ * @param number of threads
+ * @return passed or not
+ */
+static bool testSort(const vector<Vector3d>& va, int nt) {
+    ConvexHull ch;
+    ConvexHull::Mesh mesh;
+    if (!ch.construct(va)) {
+        return false;
+    }
+    ch.extract(mesh);
+    vector<array<ID, 3>> kt = getTriangles(mesh);
+    ch.setThreads(nt);
+    if (!ch.construct(va)) {
+        return false;
+    }
+    ch.extract(mesh);
+    return (getTriangles(mesh) == kt);
+}
+
+/**
+ * Culls interior vertices before the construction and checks the convex hull
+ *  - culled vertices are strictly in the convex hull and the order of ids
+ *    of the others is kept, so that vertices on the convex hull are the same
+ *    as those without the culling, even on degenerate vertices
+ * @param vertices
+ * @param number of threads
+ * @return passed or not
+ */
+static bool testCulling(const vector<Vector3d>& va, int nt) {
+    ConvexHull ch;
+    ch.setThreads(nt);
+    ConvexHull::Mesh mesh;
+    ch.construct(va);
+    ch.extract(mesh);
+    vector<ID> kvi(mesh.kvi);
+    sort(kvi.begin(), kvi.end());
+    for (ConvexHull::Culling c : { ConvexHull::Culling::OCTAHEDRON, ConvexHull::Culling::POLYTOPE26 }) {
+        ch.setCulling(c);
+        if (!ch.construct(va)) {
+            return false;
+        }
+        ch.extract(mesh);
+        vector<ID> kvic(mesh.kvi);
+        sort(kvic.begin(), kvic.end());
+        if (kvic != kvi || !isConvexHull(va, mesh)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Appends vertices chunk by chunk and checks the convex hull
+ *  - chunks out of x order overlap the convex hull and construct it again,
+ *    and chunks in x order are merged to the right side of it
+ * @param vertices
+ * @param number of vertices of each chunk
+ * @param sorts vertices in x order or not
+ * @return passed or not
+ */
+static bool testAppend(vector<Vector3d> va, size_t nc, bool sorted) {
+    if (sorted) {
+        sort(va.begin(), va.end(), [](const Vector3d& a, const Vector3d& b) {
+            return lexicographical_compare(a.get(), a.get() + 3, b.get(), b.get() + 3);
+        });
+    }
+    ConvexHull ch;
+    for (size_t i = 0; i < va.size(); i += nc) {
+        vector<Vector3d> vc(va.begin() + i, va.begin() + min(va.size(), i + nc));
+        if (!ch.append(vc)) {
+            return false;
+        }
+    }
+    ConvexHull::Mesh mesh;
+    ch.extract(mesh);
+    return isConvexHull(va, mesh);
+}
+
+/**
+ * Inserts vertices one by one into the constructed convex hull and checks it
+ *  - vertices in the convex hull, out of it, on its faces and edges,
+ *    on planes of its faces out of it, and duplicates of its vertices
+ * @param vertices to construct the convex hull of the cube
+ * @param vertices to insert
+ * @return passed or not
+ */
+static bool testInsert(const vector<Vector3d>& va, const vector<Vector3d>& vi) {
+    ConvexHull ch;
+    if (!ch.construct(va)) {
+        return false;
+    }
+    vector<Vector3d> vb(va);
+    for (const Vector3d& v : vi) {
+        ch.insert(v);
+        vb.push_back(v);
+        // the convex hull is valid after each insertion
+        ConvexHull::Mesh mesh;
+        ch.extract(mesh);
+        if (!isConvexHull(vb, mesh)) {
+            return false;
+        }
+    }
+    // the batch of vertices keeps the order of the input
+    ConvexHull ch2;
+    ch2.construct(va);
+    ch2.insert(vi);
+    ConvexHull::Mesh mesh;
+    ch2.extract(mesh);
+    return isConvexHull(vb, mesh);
+}
+
+/**
+ * Rejects vertices more than ids of edges can number
+ *  - the view is not read, the size is checked first
+ * @return passed or not
+ */
+static bool testTooManyVertices() {
+    Vector3d v;
+    VertexView vw(&v, (size_t)numeric_limits<ID>::max(), 0, VertexView::Type::FLOAT64);
+    ConvexHull ch;
+    return !ch.construct(vw) && !ch.append(vw);
+}
+
+/**
+ * Rejects the PLY whose count of elements exceeds the file
+ * @param count of vertices in the header
+ * @return passed or not
+ */
+static bool testPLYCount(const string& count) {
+    string fn = "/tmp/ch3d-test-" + to_string(getpid()) + ".ply";
+    FILE* fp = fopen(fn.c_str(), "wb");
+    if (!fp) {
+        return false;
+    }
+    fprintf(fp, "ply\nformat binary_little_endian 1.0\nelement vertex %s\n"
+                "property double x\nproperty double y\nproperty double z\nend_header\n", count.c_str());
+    double v[3] = { 0.0, 0.0, 0.0 };
+    fwrite(v, sizeof(v), 1, fp);
+    fclose(fp);
+    VertexFile vf;
+    bool ok = vf.open(fn, VertexFile::Format::PLY);
+    vf.close();
+    remove(fn.c_str());
+    return (count == "1" ? ok : !ok);
+}
+
+/**
+ * Constructs the convex hull of the cube and the far vertex
+ *  - the vertex out of the range of the grid fails the construction
+ *    and the append, and is not inserted but counted in the input
+ * @param coordinate of the far vertex
+ * @param in the range of the grid or not
+ * @return passed or not
+ */
+static bool testRange(double r, bool in) {
+    vector<Vector3d> va;
+    generateGrid(2, va);
+    va.push_back(Vector3d(r, 0.0, 0.0));
+    ConvexHull ch;
+    ConvexHull ch2;
+    if (ch.construct(va) != in || ch2.append(va) != in) {
+        return false;
+    }
+    va.pop_back();
+    ch.construct(va);
+    if (ch.insert(Vector3d(r, 0.0, 0.0)) != in) {
+        return false;
+    }
+    // the next vertex keeps its index in the input
+    ch.insert(Vector3d(-1.0, 0.0, 0.0));
+    ConvexHull::Mesh mesh;
+    ch.extract(mesh);
+    return (find(mesh.kvi.begin(), mesh.kvi.end(), (ID)va.size() + 1) != mesh.kvi.end());
+}
+
+/**
+ * Reports the result of the test
+ * @param name of the test
+ * @param passed or not
+ * @param number of failed tests
+ */
+static void report(const string& name, bool ok, int& nng) {
+    printf("%s %s\n", (ok ? "ok" : "NG"), name.c_str());
+    if (!ok) {
+        nng++;
+    }
+}
+
+/**
+ * Main
+ */
+int main() {
+    int nng = 0;
+    const int knt[] = { 1, 3, 8 };
+    const ConvexHull::MergeOrder kmo[] = { ConvexHull::MergeOrder::BREADTH_FIRST, ConvexHull::MergeOrder::DEPTH_FIRST };
+    const char* const kmn[] = { "breadth", "depth" };
+    vector<Vector3d> va;
+    // lattice points, vertices share x, y and z and 4 or more are coplanar
+    for (int nd : { 2, 3, 5, 12 }) {
+        generateGrid(nd, va);
+        for (int nt : knt) {
+            for (int i = 0; i < 2; i++) {
+                report("grid " + to_string(nd) + "^3 threads " + to_string(nt) + " " + kmn[i],
+                       testConstruct(va, nt, kmo[i]), nng);
+            }
+        }
+    }
+    // points on the sphere snapped to the coarse grid
+    for (int nv : { 1000, 10000 }) {
+        generateCosphere(nv, va);
+        for (int nt : knt) {
+            for (int i = 0; i < 2; i++) {
+                report("cosphere " + to_string(nv) + " threads " + to_string(nt) + " " + kmn[i],
+                       testConstruct(va, nt, kmo[i]), nng);
+            }
+        }
+    }
+    // points in general position, small convex hulls are flat dihedra
+    // and the wrap of the merge visits their vertices more than once
+    for (int nt : { 2, 3, 8 }) {
+        for (int i = 0; i < 2; i++) {
+            bool ok = true;
+            for (int seed = 0; seed < 100 && ok; seed++) {
+                generateUniform(8 + seed % 40, seed, va);
+                ok = testConstruct(va, nt, kmo[i]);
+            }
+            for (int seed = 0; seed < 4 && ok; seed++) {
+                generateUniform(3000, seed, va);
+                ok = testConstruct(va, nt, kmo[i]);
+            }
+            report("uniform threads " + to_string(nt) + " " + kmn[i], ok, nng);
+        }
+    }
+    // sample sort on threads of more vertices than 2 * NSORT, and duplicates
+    for (int nt : { 2, 3, 8 }) {
+        generateUniform(200000, 3, va);
+        va.insert(va.end(), va.begin(), va.begin() + 50000);
+        report("sort uniform 250000 threads " + to_string(nt), testSort(va, nt), nng);
+        generateCosphere(200000, va);
+        report("sort cosphere 200000 threads " + to_string(nt), testSort(va, nt), nng);
+    }
+    // culling of interior vertices of more vertices than NCULL
+    for (int nt : { 1, 3 }) {
+        generateUniform(20000, 1, va);
+        report("culling uniform 20000 threads " + to_string(nt), testCulling(va, nt), nng);
+        generateGrid(20, va);
+        report("culling grid 20^3 threads " + to_string(nt), testCulling(va, nt), nng);
+        // points on the sphere and points in the cube in it
+        vector<Vector3d> vb;
+        generateUniform(10000, 2, vb);
+        generateCosphere(10000, va);
+        for (const Vector3d& v : vb) {
+            va.push_back(Vector3d(round(v.get()[0] * 0.5 * UNIT) / UNIT,
+                                  round(v.get()[1] * 0.5 * UNIT) / UNIT,
+                                  round(v.get()[2] * 0.5 * UNIT) / UNIT));
+        }
+        report("culling cosphere 10000 threads " + to_string(nt), testCulling(va, nt), nng);
+    }
+    // chunks of the stream out of x order and in x order
+    generateCosphere(10000, va);
+    for (size_t nc : { 10, 1000 }) {
+        report("append cosphere chunks " + to_string(nc), testAppend(va, nc, false), nng);
+        report("append sorted cosphere chunks " + to_string(nc), testAppend(va, nc, true), nng);
+    }
+    // insertions into the convex hull of the lattice points and of uniform points
+    {
+        vector<Vector3d> vi = {
+            Vector3d(0.2, 0.2, 0.2),                            // in the convex hull
+            Vector3d(0.0, 0.25, 0.15),                          // on the face
+            Vector3d(0.0, 0.0, 0.15),                           // on the edge
+            Vector3d(0.0, 0.1, 0.0),                            // duplicate of the vertex
+            Vector3d(0.0, 0.6, 0.2),                            // on the plane of the face
+            Vector3d(0.6, 0.6, 0.6),                            // out of the convex hull
+            Vector3d(-0.1, 0.2, 0.2),                           // out of the convex hull
+            Vector3d(-0.05, 0.2, 0.2),                          // in the convex hull now
+        };
+        generateGrid(5, va);
+        report("insert grid 5^3", testInsert(va, vi), nng);
+        vector<Vector3d> vb;
+        generateUniform(200, 4, vb);
+        for (Vector3d& v : vb) {
+            v = Vector3d(round(v.get()[0] * 1.5 * UNIT) / UNIT, round(v.get()[1] * 1.5 * UNIT) / UNIT, round(v.get()[2] * 1.5 * UNIT) / UNIT);
+        }
+        generateUniform(1000, 5, va);
+        report("insert uniform 1000", testInsert(va, vb), nng);
+    }
+    // limits of ids, files and the grid
+    report("in the range of the grid", testRange(0.5 * GRIDMAX * PREC, true), nng);
+    report("out of the range of the grid", testRange(2.0 * GRIDMAX * PREC, false), nng);
+    report("not a number", testRange(nan(""), false), nng);
+    // beyond the 32 bit grid of make GRID32=1 only
+    report("3e3 on the grid", testRange(3.0e3, 3.0e3 <= GRIDMAX * PREC), nng);
+    report("too many vertices", testTooManyVertices(), nng);
+    for (const char* count : { "1", "2", "-1", "768614336404564651", "99999999999999999999" }) {
+        report(string("ply vertices ") + count, testPLYCount(count), nng);
+    }
+    return nng;
+}